@@ -16,14 +16,18 @@
 
 #include "google/ads/googleads/v16/services/google_ads_service.upbdefs.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/struct.pb.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/json/json.h"
+#include "google/protobuf/text_format.h"
 #include "benchmarks/descriptor.pb.h"
 #include "benchmarks/descriptor.upb.h"
 #include "benchmarks/descriptor.upbdefs.h"
+#include "benchmarks/descriptor_json_codegen.pb.h"
 #include "benchmarks/descriptor_sv.pb.h"
+#include "benchmarks/inline_string.pb.h"
 #include "upb/base/string_view.h"
 #include "upb/base/upcast.h"
 #include "upb/json/decode.h"
@@ -197,6 +201,33 @@ static void BM_LoadAdsDescriptor_Upb(benchmark::State& state) {
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Upb, NoLayout);
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Upb, WithLayout);
 
+// Counts the descriptors that building `message` creates in a DescriptorPool.
+static size_t CountDescriptors(const protobuf::DescriptorProto& message) {
+  size_t count = 1 + message.field_size() + message.extension_size() +
+                 message.oneof_decl_size();
+  for (const auto& nested : message.nested_type()) {
+    count += CountDescriptors(nested);
+  }
+  for (const auto& enum_type : message.enum_type()) {
+    count += 1 + enum_type.value_size();
+  }
+  return count;
+}
+
+static size_t CountDescriptors(const protobuf::FileDescriptorProto& file) {
+  size_t count = 1 + file.extension_size();
+  for (const auto& message : file.message_type()) {
+    count += CountDescriptors(message);
+  }
+  for (const auto& enum_type : file.enum_type()) {
+    count += 1 + enum_type.value_size();
+  }
+  for (const auto& service : file.service()) {
+    count += 1 + service.method_size();
+  }
+  return count;
+}
+
 template <LoadDescriptorMode Mode>
 static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
   extern _upb_DefPool_Init
@@ -207,8 +238,11 @@ static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
       &google_ads_googleads_v16_services_google_ads_service_proto_upbdefinit,
       serialized_files, seen_files);
   size_t bytes_per_iter = 0;
+  size_t descriptors = 0;
+  size_t pool_bytes = 0;
   for (auto _ : state) {
     bytes_per_iter = 0;
+    descriptors = 0;
     protobuf::Arena arena;
     protobuf::DescriptorPool pool;
     for (auto file : serialized_files) {
@@ -222,7 +256,9 @@ static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
         exit(1);
       }
       bytes_per_iter += input.size();
+      descriptors += CountDescriptors(*proto);
     }
+    pool_bytes = pool.InternalSpaceUsed();
 
     if (Mode == WithLayout) {
       protobuf::DynamicMessageFactory factory;
@@ -236,6 +272,10 @@ static void BM_LoadAdsDescriptor_Proto2(benchmark::State& state) {
     }
   }
   state.SetBytesProcessed(state.iterations() * bytes_per_iter);
+  if (descriptors > 0) {
+    state.counters["pool_bytes_per_descriptor"] =
+        static_cast<double>(pool_bytes) / descriptors;
+  }
 }
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, NoLayout);
 BENCHMARK_TEMPLATE(BM_LoadAdsDescriptor_Proto2, WithLayout);
@@ -341,6 +381,41 @@ BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, UseArena, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDesc, InitBlock, Copy);
 BENCHMARK_TEMPLATE(BM_Parse_Proto2, FileDescSV, InitBlock, Alias);
 
+// Parses messages whose string fields are stored behind an ArenaStringPtr
+// (StringFields) or inlined with `features.(pb.cpp).inline_string`
+// (InlinedStringFields).  Both have the same wire format.
+constexpr int kMessagesPerArena = 64;
+
+template <class P>
+static void BM_Parse_StringFields(benchmark::State& state) {
+  const std::string value(state.range(0), 'x');
+  upb_benchmark::StringFields fields;
+  for (std::string* field :
+       {fields.mutable_f1(), fields.mutable_f2(), fields.mutable_f3(),
+        fields.mutable_f4(), fields.mutable_f5(), fields.mutable_f6(),
+        fields.mutable_f7(), fields.mutable_f8()}) {
+    *field = value;
+  }
+  const std::string input = fields.SerializeAsString();
+  for (auto _ : state) {
+    protobuf::Arena arena;
+    for (int i = 0; i < kMessagesPerArena; ++i) {
+      if (!protobuf::Arena::Create<P>(&arena)->ParseFromString(input)) {
+        printf("Failed to parse.\n");
+        exit(1);
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * kMessagesPerArena *
+                          input.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse_StringFields, upb_benchmark::StringFields)
+    ->Arg(8)
+    ->Arg(64);
+BENCHMARK_TEMPLATE(BM_Parse_StringFields, upb_benchmark::InlinedStringFields)
+    ->Arg(8)
+    ->Arg(64);
+
 static void BM_SerializeDescriptor_Proto2(benchmark::State& state) {
   upb_benchmark::FileDescriptorProto proto;
   proto.ParseFromArray(descriptor.data, descriptor.size);
@@ -469,3 +544,96 @@ static void BM_JsonSerialize_Proto2(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * json.size());
 }
 BENCHMARK(BM_JsonSerialize_Proto2);
+
+static void BM_JsonSerialize_Codegen(benchmark::State& state) {
+  upb_benchmark::json_codegen::FileDescriptorProto proto;
+  absl::string_view input(descriptor.data, descriptor.size);
+  proto.ParseFromString(input);
+  std::string json;
+  std::string expected;
+  ABSL_CHECK_OK(proto.SerializeToJson(&json));
+  ABSL_CHECK_OK(google::protobuf::json::MessageToJsonString(proto, &expected));
+  ABSL_CHECK_EQ(json, expected);
+  for (auto _ : state) {
+    json.clear();
+    ABSL_CHECK_OK(proto.SerializeToJson(&json));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonSerialize_Codegen);
+
+static google::protobuf::ListValue MakeDoubleList() {
+  google::protobuf::ListValue list;
+  // Values whose shortest round-trip representation varies in length.
+  double value = 1.0;
+  for (int i = 0; i < 1000; ++i) {
+    value = value * 1.37 + 0.1;
+    if (value > 1e300) value = 1e-300;
+    list.add_values()->set_number_value(i % 2 == 0 ? value : -1.0 / value);
+  }
+  return list;
+}
+
+static void BM_JsonSerializeDoubles_Proto2(benchmark::State& state) {
+  google::protobuf::ListValue list = MakeDoubleList();
+  std::string json;
+  for (auto _ : state) {
+    json.clear();
+    ABSL_CHECK_OK(google::protobuf::json::MessageToJsonString(list, &json));
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonSerializeDoubles_Proto2);
+
+static void BM_TextFormatPrintDoubles_Proto2(benchmark::State& state) {
+  google::protobuf::ListValue list = MakeDoubleList();
+  std::string text;
+  for (auto _ : state) {
+    text.clear();
+    ABSL_CHECK(google::protobuf::TextFormat::PrintToString(list, &text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatPrintDoubles_Proto2);
+
+static void BM_TextFormatPrint_Proto2(benchmark::State& state) {
+  FileDesc proto;
+  absl::string_view input(descriptor.data, descriptor.size);
+  proto.ParseFromString(input);
+  std::string text;
+  for (auto _ : state) {
+    text.clear();
+    ABSL_CHECK(google::protobuf::TextFormat::PrintToString(proto, &text));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatPrint_Proto2);
+
+template <ArenaMode AMode>
+static void BM_TextFormatParse_Proto2(benchmark::State& state) {
+  FileDesc proto;
+  absl::string_view input(descriptor.data, descriptor.size);
+  proto.ParseFromString(input);
+  std::string text;
+  ABSL_CHECK(google::protobuf::TextFormat::PrintToString(proto, &text));
+  for (auto _ : state) {
+    Proto2Factory<AMode, FileDesc> proto_factory;
+    ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(
+        text, proto_factory.GetProto()));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK_TEMPLATE(BM_TextFormatParse_Proto2, NoArena);
+BENCHMARK_TEMPLATE(BM_TextFormatParse_Proto2, UseArena);
+
+static void BM_TextFormatParseDoubles_Proto2(benchmark::State& state) {
+  std::string text;
+  ABSL_CHECK(
+      google::protobuf::TextFormat::PrintToString(MakeDoubleList(), &text));
+  for (auto _ : state) {
+    google::protobuf::ListValue list;
+    ABSL_CHECK(google::protobuf::TextFormat::ParseFromString(text, &list));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_TextFormatParseDoubles_Proto2);
@@ -49,6 +49,37 @@ def cc_optimizefor_proto_library(name, srcs, outs, optimize_for):
         deps = [":" + name + "_proto"],
     )
 
+def cc_json_codegen_proto_library(name, src, package):
+    """Compiles `src` with the json_codegen option of the C++ generator.
+
+    The proto package is renamed to `package` so that the library can be linked
+    together with the regular cc_proto_library of `src`, which must not have
+    imports.
+    """
+    proto = name + ".proto"
+    native.genrule(
+        name = name + "_gen_srcs",
+        srcs = [src],
+        outs = [proto, name + ".pb.h", name + ".pb.cc"],
+        tools = ["//:protoc"],
+        cmd = " && ".join([
+            "sed 's/^package .*;/package " + package + ";/' $< > $(RULEDIR)/" + proto,
+            "$(execpath //:protoc) --cpp_out=json_codegen:$(GENDIR) " +
+            "--proto_path=$(GENDIR) $(RULEDIR)/" + proto,
+        ]),
+    )
+
+    native.cc_library(
+        name = name,
+        srcs = [name + ".pb.cc"],
+        hdrs = [name + ".pb.h"],
+        deps = [
+            "//:protobuf",
+            "//src/google/protobuf/json",
+            "//src/google/protobuf/json:generated_writer",
+        ],
+    )
+
 def expand_suffixes(vals, suffixes):
     ret = []
     for val in vals:
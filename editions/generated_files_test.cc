@@ -150,6 +150,7 @@ TEST(Generated, EditionDefaults2023InternalFeatures) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 }
               )pb"));
 }
@@ -528,6 +528,14 @@ class PROTOBUF_EXPORT PROTOBUF_ALIGNAS(8) Arena final {
     impl_.ReturnArrayMemory(p, size);
   }
 
+  // Tries to grow an array allocation of `old_size` bytes at `p` to
+  // `new_size` bytes in place. Returns false if the memory must be moved.
+  bool TryExtendArrayInPlace(void* p, size_t old_size, size_t new_size) {
+    return impl_.TryExtendArrayInPlace(
+        p, internal::ArenaAlignDefault::Ceil(old_size),
+        internal::ArenaAlignDefault::Ceil(new_size));
+  }
+
   template <typename T, typename... Args>
   PROTOBUF_NDEBUG_INLINE static T* CreateArenaCompatible(Arena* arena,
                                                          Args&&... args) {
@@ -1839,6 +1839,37 @@ TEST(ArenaTest, SpaceReuseForArraysSizeChecks) {
   }
 }
 
+TEST(ArenaTest, RepeatedFieldGrowsInPlaceWhenLastAllocation) {
+  char buf[4096];
+  Arena arena(buf, sizeof(buf));
+  auto* field = Arena::Create<RepeatedField<int>>(&arena);
+  field->Reserve(16);
+  const int* data = field->data();
+  const uint64_t space_used = arena.SpaceUsed();
+  field->Reserve(64);
+  EXPECT_EQ(field->data(), data);
+  EXPECT_GE(field->Capacity(), 64);
+  // Only the extra bytes were taken from the block.
+  EXPECT_EQ(arena.SpaceUsed() - space_used,
+            (field->Capacity() - 16) * sizeof(int));
+
+  // Once something else is allocated after it, the field has to move.
+  Arena::CreateArray<char>(&arena, 8);
+  field->Reserve(field->Capacity() + 1);
+  EXPECT_NE(field->data(), data);
+}
+
+TEST(ArenaTest, RepeatedPtrFieldGrowsInPlaceWhenLastAllocation) {
+  char buf[4096];
+  Arena arena(buf, sizeof(buf));
+  auto* field = Arena::Create<RepeatedPtrField<std::string>>(&arena);
+  field->Reserve(16);
+  const void* data = field->data();
+  field->Reserve(64);
+  EXPECT_EQ(field->data(), data);
+  EXPECT_GE(field->Capacity(), 64);
+}
+
 TEST(ArenaTest, SpaceReusePoisonsAndUnpoisonsMemory) {
 #ifdef PROTOBUF_ASAN
   char buf[1024]{};
@@ -233,6 +233,33 @@ pb::CppFeatures::StringType FieldGeneratorBase::GetDeclaredStringType() const {
       .string_type();
 }
 
+bool IsStringInlined(const FieldDescriptor* field, const Options& options) {
+  (void)options;
+  if (!CanStringBeInlined(field)) return false;
+  return CppGenerator::GetResolvedSourceFeatures(*field)
+      .GetExtension(pb::cpp)
+      .inline_string();
+}
+
+static bool HasInlinedStrings(const Descriptor* descriptor,
+                              const Options& options) {
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    if (IsStringInlined(descriptor->field(i), options)) return true;
+  }
+  for (int i = 0; i < descriptor->nested_type_count(); ++i) {
+    if (HasInlinedStrings(descriptor->nested_type(i), options)) return true;
+  }
+  return false;
+}
+
+bool HasInlinedStrings(const FileDescriptor* file, const Options& options) {
+  if (IsStringInliningEnabled(options)) return true;
+  for (int i = 0; i < file->message_type_count(); ++i) {
+    if (HasInlinedStrings(file->message_type(i), options)) return true;
+  }
+  return false;
+}
+
 namespace {
 std::unique_ptr<FieldGeneratorBase> MakeGenerator(const FieldDescriptor* field,
                                                   const Options& options,
@@ -240,6 +240,13 @@ void FileGenerator::GenerateSharedHeaderCode(io::Printer* p) {
                ::absl::string_view GetAnyMessageName();
                }  // namespace internal
              )cc");
+             if (HasJsonMethods(file_, options_)) {
+               p->Emit(R"cc(
+                 namespace json_internal {
+                 class GeneratedJsonWriter;
+                 }  // namespace json_internal
+               )cc");
+             }
            }},
           {"fwd_decls", [&] { GenerateForwardDeclarations(p); }},
           {"proto2_ns_enums",
@@ -509,6 +516,11 @@ void FileGenerator::GenerateSourceIncludes(io::Printer* p) {
     IncludeFile("third_party/protobuf/wire_format.h", p);
   }
 
+  if (HasJsonMethods(file_, options_)) {
+    IncludeFile("third_party/protobuf/json/internal/generated_writer.h", p);
+    IncludeFile("third_party/protobuf/json/json.h", p);
+  }
+
   if (options_.proto_h) {
     // Use the smaller .proto.h files.
     for (int i = 0; i < file_->dependency_count(); ++i) {
@@ -1620,7 +1632,7 @@ void FileGenerator::GenerateLibraryIncludes(io::Printer* p) {
   IncludeFile("third_party/protobuf/io/coded_stream.h", p);
   IncludeFile("third_party/protobuf/arena.h", p);
   IncludeFile("third_party/protobuf/arenastring.h", p);
-  if (IsStringInliningEnabled(options_)) {
+  if (HasInlinedStrings(file_, options_)) {
     IncludeFile("third_party/protobuf/inlined_string_field.h", p);
   }
   if (HasSimpleBaseClasses(file_, options_)) {
@@ -1685,6 +1697,12 @@ void FileGenerator::GenerateLibraryIncludes(io::Printer* p) {
     IncludeFile("third_party/protobuf/service.h", p);
   }
 
+  if (HasJsonMethods(file_, options_)) {
+    p->Emit(R"(
+      #include "absl/status/status.h"
+      )");
+  }
+
   if (UseUnknownFieldSet(file_, options_) && !message_generators_.empty()) {
     IncludeFile("third_party/protobuf/unknown_field_set.h", p);
   }
@@ -119,6 +119,11 @@ bool CppGenerator::Generate(const FileDescriptor* file,
   //
   // If the lite option is passed to the compiler, we will generate the
   // current files and all transitive dependencies using the LITE runtime.
+  //
+  // If the json_codegen option is passed to the compiler, messages get a
+  // generated SerializeToJson() method. The generated code depends on the JSON
+  // library, which must be linked in. Parsing still goes through
+  // json::JsonStringToMessage().
   Options file_options;
 
   file_options.opensource_runtime = opensource_runtime_;
@@ -184,6 +189,8 @@ bool CppGenerator::Generate(const FileDescriptor* file,
       file_options.force_eagerly_verified_lazy = true;
     } else if (key == "experimental_strip_nonfunctional_codegen") {
       file_options.strip_nonfunctional_codegen = true;
+    } else if (key == "json_codegen") {
+      file_options.json_codegen = true;
     } else {
       *error = absl::StrCat("Unknown generator option: ", key);
       return false;
@@ -411,6 +418,13 @@ absl::Status CppGenerator::ValidateFeatures(const FileDescriptor* file) const {
       }
     }
 
+    if (unresolved_features.has_inline_string() &&
+        field.cpp_type() != FieldDescriptor::CPPTYPE_STRING) {
+      status = absl::FailedPreconditionError(absl::StrCat(
+          "Field ", field.full_name(),
+          " specifies inline_string, but is not a string nor bytes field."));
+    }
+
     if (field.options().has_ctype()) {
       if (field.cpp_type() != FieldDescriptor::CPPTYPE_STRING) {
         status = absl::FailedPreconditionError(absl::StrCat(
@@ -8,9 +8,14 @@
 #include "google/protobuf/compiler/cpp/generator.h"
 
 #include <memory>
+#include <string>
 
+#include "google/protobuf/testing/file.h"
 #include "google/protobuf/descriptor.pb.h"
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/log/absl_check.h"
+#include "absl/strings/str_cat.h"
 #include "google/protobuf/compiler/command_line_interface_tester.h"
 #include "google/protobuf/cpp_features.pb.h"
 
@@ -20,6 +25,9 @@ namespace compiler {
 namespace cpp {
 namespace {
 
+using ::testing::HasSubstr;
+using ::testing::Not;
+
 class CppGeneratorTest : public CommandLineInterfaceTester {
  protected:
   CppGeneratorTest() {
@@ -33,6 +41,13 @@ class CppGeneratorTest : public CommandLineInterfaceTester {
     CreateTempFile("google/protobuf/cpp_features.proto",
                    pb::CppFeatures::descriptor()->file()->DebugString());
   }
+
+  std::string ReadOutput(absl::string_view name) {
+    std::string contents;
+    ABSL_CHECK_OK(File::GetContents(absl::StrCat(temp_directory(), "/", name),
+                                    &contents, true));
+    return contents;
+  }
 };
 
 TEST_F(CppGeneratorTest, Basic) {
@@ -280,6 +295,45 @@ TEST_F(CppGeneratorTest, InheritedStringTypeCordNotForExtension) {
   ExpectNoErrors();
 }
 
+TEST_F(CppGeneratorTest, InlineString) {
+  CreateTempFile("foo.proto", R"schema(
+    edition = "2023";
+    import "google/protobuf/cpp_features.proto";
+
+    message Foo {
+      option features.(pb.cpp).inline_string = true;
+      string bar = 1;
+      bytes baz = 2;
+      repeated string qux = 3;
+      int32 quux = 4;
+      string corge = 5 [features.field_presence = IMPLICIT];
+    }
+  )schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+}
+
+TEST_F(CppGeneratorTest, InlineStringForStringFieldsOnly) {
+  CreateTempFile("foo.proto", R"schema(
+    edition = "2023";
+    import "google/protobuf/cpp_features.proto";
+
+    message Foo {
+      int32 bar = 1 [features.(pb.cpp).inline_string = true];
+    }
+  )schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir foo.proto");
+
+  ExpectErrorSubstring(
+      "Field Foo.bar specifies inline_string, but is not a string nor bytes "
+      "field.");
+}
+
 TEST_F(CppGeneratorTest, CtypeOnNoneStringFieldTest) {
   CreateTempFile("foo.proto",
                  R"schema(
@@ -310,6 +364,63 @@ TEST_F(CppGeneratorTest, CtypeOnExtensionTest) {
       "Extension bar specifies Cord type which is "
       "not supported for extensions.");
 }
+
+TEST_F(CppGeneratorTest, JsonCodegen) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto3";
+    import "google/protobuf/descriptor.proto";
+    message Foo {
+      enum Kind {
+        KIND_UNKNOWN = 0;
+      }
+      int64 id = 1;
+      string display_name = 2;
+      repeated Kind kinds = 3;
+      map<string, Foo> children = 4;
+      google.protobuf.FileDescriptorProto file = 5;
+      bytes Payload = 6 [json_name = "payload"];
+      int32 Foo_bar = 7;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir "
+      "--cpp_opt=json_codegen foo.proto");
+
+  ExpectNoErrors();
+  std::string pb_h = ReadOutput("foo.pb.h");
+  std::string pb_cc = ReadOutput("foo.pb.cc");
+  EXPECT_THAT(pb_h, HasSubstr("::absl::Status SerializeToJson("));
+  EXPECT_THAT(pb_h, Not(HasSubstr("ParseFromJson(")));
+  // Keys are precomputed as the reflective writer computes them: the capital
+  // of PascalCase names is restored on their camel case json name.
+  EXPECT_THAT(pb_cc, HasSubstr(R"(writer.WriteRaw("\"displayName\":");)"));
+  EXPECT_THAT(pb_cc, HasSubstr(R"(writer.WriteRaw("\"Payload\":");)"));
+  EXPECT_THAT(pb_cc, HasSubstr(R"(writer.WriteRaw("\"Foo_bar\":");)"));
+  EXPECT_THAT(pb_cc, HasSubstr("writer.WriteEnum("));
+  EXPECT_THAT(pb_cc, HasSubstr("Foo_Kind_Name("));
+  EXPECT_THAT(pb_cc, HasSubstr("_InternalWriteJson(writer)"));
+  // Messages from other files are written through reflection.
+  EXPECT_THAT(pb_cc, HasSubstr("writer.WriteMessage("));
+  // Generated code only uses the exported writer.
+  EXPECT_THAT(pb_cc, Not(HasSubstr("json_internal::JsonWriter")));
+  EXPECT_THAT(pb_cc, Not(HasSubstr("WriteMessageWithReflection(")));
+}
+
+TEST_F(CppGeneratorTest, NoJsonCodegenByDefault) {
+  CreateTempFile("foo.proto",
+                 R"schema(
+    syntax = "proto3";
+    message Foo {
+      int32 bar = 1;
+    })schema");
+
+  RunProtoc(
+      "protocol_compiler --proto_path=$tmpdir --cpp_out=$tmpdir foo.proto");
+
+  ExpectNoErrors();
+  EXPECT_THAT(ReadOutput("foo.pb.h"), Not(HasSubstr("SerializeToJson")));
+}
 }  // namespace
 }  // namespace cpp
 }  // namespace compiler
@@ -982,12 +982,6 @@ bool CanStringBeInlined(const FieldDescriptor* field) {
   return true;
 }
 
-bool IsStringInlined(const FieldDescriptor* field, const Options& options) {
-  (void)field;
-  (void)options;
-  return false;
-}
-
 static bool HasLazyFields(const Descriptor* descriptor, const Options& options,
                           MessageSCCAnalyzer* scc_analyzer) {
   for (int field_idx = 0; field_idx < descriptor->field_count(); field_idx++) {
@@ -356,11 +356,16 @@ bool IsStringInliningEnabled(const Options& options);
 // Returns true if the provided field is a singular string and can be inlined.
 bool CanStringBeInlined(const FieldDescriptor* field);
 
-// Returns true if `field` is a string field that can and should be inlined
-// based on PDProto profile.
+// Returns true if `field` is a string field that can be inlined and has the
+// `inline_string` C++ feature enabled. Defined in field.cc along with
+// HasInlinedStrings(), as both read features resolved by CppGenerator.
 bool IsStringInlined(const FieldDescriptor* field, const Options& options);
 
-// Returns true if `field` should be inlined based on PDProto profile.
+// Returns true if any message in `file` may contain inlined string fields, in
+// which case the generated header needs InlinedStringField.
+bool HasInlinedStrings(const FileDescriptor* file, const Options& options);
+
+// Returns true if `field` should be inlined.
 // Currently we only enable inlining for string fields backed by a std::string
 // instance, but in the future we may expand this to message types.
 inline bool IsFieldInlined(const FieldDescriptor* field,
@@ -485,6 +490,13 @@ inline bool HasDescriptorMethods(const FileDescriptor* file,
   return GetOptimizeFor(file, options) != FileOptions::LITE_RUNTIME;
 }
 
+// Do message classes in this file have generated JSON methods? These fall back
+// to reflection for some messages, so they need descriptor methods.
+inline bool HasJsonMethods(const FileDescriptor* file,
+                           const Options& options) {
+  return options.json_codegen && HasDescriptorMethods(file, options);
+}
+
 // Should we generate generic services for this file?
 inline bool HasGenericServices(const FileDescriptor* file,
                                const Options& options) {
@@ -529,6 +529,144 @@ std::vector<Sub> ClassVars(const Descriptor* desc, Options opts) {
   return vars;
 }
 
+// Returns true if the JSON methods generated for `descriptor` can write it
+// without falling back to reflection.
+bool CanGenerateJsonWriter(const Descriptor* descriptor) {
+  // Well-known types have special JSON mappings, and extensions have to be
+  // found through reflection.
+  if (IsWellKnownMessage(descriptor->file()) ||
+      descriptor->extension_range_count() > 0) {
+    return false;
+  }
+  for (const auto* field : FieldRange(descriptor)) {
+    if (field->options().weak()) return false;
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING &&
+        field->cpp_string_type() == FieldDescriptor::CppStringType::kCord) {
+      return false;
+    }
+    // Empty google.protobuf.Values are omitted along with their key. Maps are
+    // written through reflection, which takes care of that.
+    if (!field->is_map() && field->message_type() != nullptr &&
+        field->message_type()->full_name() == "google.protobuf.Value") {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the key that json::MessageToJsonString() writes for `field` with the
+// default options. Mirrors WriteField() in json/internal/unparser.cc, with the
+// json name of UnparseProto2Descriptor::FieldJsonName().
+std::string JsonFieldName(const FieldDescriptor* field) {
+  absl::string_view original_name = field->name();
+  absl::string_view json_name =
+      field->has_json_name() ? field->json_name() : field->camelcase_name();
+  if (absl::ascii_isupper(original_name[0]) &&
+      !absl::ascii_isupper(json_name[0])) {
+    return absl::StrCat(
+        std::string(1, absl::ascii_toupper(original_name[0])),
+        original_name.substr(1));
+  }
+  return std::string(json_name);
+}
+
+// Returns true if the JSON writer does not escape any character of `str`.
+bool IsUnescapedInJson(absl::string_view str) {
+  for (char c : str) {
+    if (c < 0x20 || c >= 0x7f || c == '"' || c == '\\' || c == '<' ||
+        c == '>') {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Emits code writing `value`, a value of the singular or repeated field
+// `field`, to `writer`. Mirrors WriteSingular() in json/internal/unparser.cc.
+void EmitJsonWriteValue(io::Printer* p, const FieldDescriptor* field,
+                        absl::string_view value, const Options& options) {
+  auto v = p->WithVars({{"value", value}});
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      p->Emit(R"cc(
+        writer.WriteInt32($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      p->Emit(R"cc(
+        writer.WriteUInt32($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      p->Emit(R"cc(
+        writer.WriteInt64($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      p->Emit(R"cc(
+        writer.WriteUInt64($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      p->Emit(R"cc(
+        writer.WriteFloat($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      p->Emit(R"cc(
+        writer.WriteDouble($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      p->Emit(R"cc(
+        writer.WriteBool($value$);
+      )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      if (field->type() == FieldDescriptor::TYPE_BYTES) {
+        p->Emit(R"cc(
+          writer.WriteBytes($value$);
+        )cc");
+      } else {
+        p->Emit(R"cc(
+          writer.WriteString($value$);
+        )cc");
+      }
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      if (field->enum_type()->full_name() == "google.protobuf.NullValue") {
+        p->Emit(R"cc(
+          writer.WriteRaw("null");
+        )cc");
+        break;
+      }
+      p->Emit({{"Enum", QualifiedClassName(field->enum_type(), options)}},
+              R"cc(
+                writer.WriteEnum($Enum$_Name($value$),
+                                 static_cast<::int32_t>($value$));
+              )cc");
+      break;
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      // Messages from other files may not have generated JSON methods.
+      if (field->message_type()->file() == field->file()) {
+        p->Emit(R"cc(
+          {
+            ::absl::Status status = $value$._InternalWriteJson(writer);
+            if (!status.ok()) return status;
+          }
+        )cc");
+      } else {
+        p->Emit(R"cc(
+          {
+            ::absl::Status status = writer.WriteMessage($value$);
+            if (!status.ok()) return status;
+          }
+        )cc");
+      }
+      break;
+  }
+}
+
 }  // anonymous namespace
 
 // ===================================================================
@@ -1901,6 +2039,18 @@ void MessageGenerator::GenerateClassDefinition(io::Printer* p) {
             static constexpr int _kInternalFieldNumber = $field_count$;
           )cc");
         }},
+       {"decl_json_methods",
+        [&] {
+          if (!HasJsonMethods(descriptor_->file(), options_)) return;
+          p->Emit(R"cc(
+            // json ------------------------------------------------------------
+
+            // Same as json::MessageToJsonString() with the default options.
+            ::absl::Status SerializeToJson(std::string* output) const;
+            ::absl::Status _InternalWriteJson(
+                ::$proto_ns$::json_internal::GeneratedJsonWriter& writer) const;
+          )cc");
+        }},
        {"decl_non_simple_base",
         [&] {
           if (HasSimpleBaseClass(descriptor_, options_)) return;
@@ -2143,6 +2293,7 @@ void MessageGenerator::GenerateClassDefinition(io::Printer* p) {
           }
           $generated_methods$;
           $internal_field_number$;
+          $decl_json_methods$;
           $decl_non_simple_base$;
           //~ Friend the template function GetAnyMessageName<T>() so that it can
           //~ call this FullMessageName() method.
@@ -2420,6 +2571,11 @@ void MessageGenerator::GenerateClassMethods(io::Printer* p) {
     p->Emit("\n");
   }
 
+  if (HasJsonMethods(descriptor_->file(), options_)) {
+    GenerateJsonMethods(p);
+    p->Emit("\n");
+  }
+
   if (ShouldSplit(descriptor_, options_)) {
     p->Emit({{"split_default",
               DefaultInstanceName(descriptor_, options_, /*split=*/true)},
@@ -5187,6 +5343,141 @@ void MessageGenerator::GenerateByteSize(io::Printer* p) {
       )cc");
 }
 
+void MessageGenerator::GenerateJsonMethods(io::Printer* p) {
+  auto emit_field = [&](const FieldDescriptor* field) {
+    const std::string name = FieldName(field);
+    const std::string json_name = JsonFieldName(field);
+    auto v = p->WithVars({{"name", name}});
+    p->Emit(
+        {{"has",
+          [&] {
+            if (field->is_map()) {
+              p->Emit("!this_.$name$().empty()");
+            } else if (field->is_repeated()) {
+              p->Emit("this_.$name$_size() > 0");
+            } else if (field->has_presence()) {
+              p->Emit("this_.has_$name$()");
+            } else {
+              EmitNonDefaultCheck(p, "this_.", field);
+            }
+          }},
+         {"key",
+          [&] {
+            // Keys are quoted and escaped at compile time where possible.
+            if (IsUnescapedInJson(json_name)) {
+              p->Emit({{"key", absl::CEscape(absl::StrCat("\"", json_name,
+                                                          "\":"))}},
+                      R"cc(
+                        writer.WriteRaw("$key$");
+                      )cc");
+              return;
+            }
+            p->Emit({{"json_name", absl::CEscape(json_name)}}, R"cc(
+              writer.WriteKey("$json_name$");
+            )cc");
+          }},
+         {"value",
+          [&] {
+            if (field->is_map()) {
+              // Reflection writes the entries in the order of the repeated
+              // field backing the map, which differs from the order of the
+              // map once the map has been accessed as a repeated field, e.g.
+              // by the parsers.
+              p->Emit({{"index", field->index()}}, R"cc(
+                {
+                  ::absl::Status status = writer.WriteMapField(
+                      this_, *this_.GetDescriptor()->field($index$));
+                  if (!status.ok()) return status;
+                }
+              )cc");
+            } else if (field->is_repeated()) {
+              p->Emit({{"write_value",
+                        [&] {
+                          EmitJsonWriteValue(
+                              p, field, absl::StrCat("this_.", name, "(i)"),
+                              options_);
+                        }}},
+                      R"cc(
+                        writer.WriteRaw("[");
+                        for (int i = 0, n = this_.$name$_size(); i < n; ++i) {
+                          if (i > 0) writer.WriteRaw(",");
+                          $write_value$;
+                        }
+                        writer.WriteRaw("]");
+                      )cc");
+            } else {
+              EmitJsonWriteValue(p, field, absl::StrCat("this_.", name, "()"),
+                                 options_);
+            }
+          }}},
+        R"cc(
+          if ($has$) {
+            writer.WriteComma(first);
+            $key$;
+            $value$;
+          }
+        )cc");
+  };
+
+  const bool generate_writer = CanGenerateJsonWriter(descriptor_);
+  p->Emit(
+      {{"serialize_body",
+        [&] {
+          if (!generate_writer) {
+            p->Emit(R"cc(
+              return ::$proto_ns$::json::MessageToJsonString(*this, output);
+            )cc");
+            return;
+          }
+          p->Emit(R"cc(
+            ::$proto_ns$::json_internal::GeneratedJsonWriter writer(output);
+            return _InternalWriteJson(writer);
+          )cc");
+        }},
+       {"body",
+        [&] {
+          if (!generate_writer) {
+            p->Emit(R"cc(
+              return writer.WriteMessage(*this);
+            )cc");
+            return;
+          }
+          if (descriptor_->field_count() == 0) {
+            p->Emit(R"cc(
+              writer.WriteRaw("{}");
+              return ::absl::OkStatus();
+            )cc");
+            return;
+          }
+          // Fields are written in field number order, as reflection does.
+          p->Emit({{"fields",
+                    [&] {
+                      for (const auto* field :
+                           SortFieldsByNumber(descriptor_)) {
+                        emit_field(field);
+                      }
+                    }}},
+                  R"cc(
+                    const $classname$& this_ = *this;
+                    bool first = true;
+                    writer.WriteRaw("{");
+                    $fields$;
+                    writer.WriteRaw("}");
+                    return ::absl::OkStatus();
+                  )cc");
+        }}},
+      R"cc(
+        ::absl::Status $classname$::SerializeToJson(std::string* output) const {
+          $serialize_body$;
+        }
+
+        ::absl::Status $classname$::_InternalWriteJson(
+            ::$proto_ns$::json_internal::GeneratedJsonWriter& writer) const {
+          $body$;
+        }
+      )cc");
+}
+
 bool MessageGenerator::NeedsIsInitialized() {
   if (HasSimpleBaseClass(descriptor_, options_)) return false;
   if (descriptor_->extension_range_count() != 0) return true;
@@ -132,6 +132,7 @@ class MessageGenerator {
   void GenerateCopyFrom(io::Printer* p);
   void GenerateSwap(io::Printer* p);
   void GenerateIsInitialized(io::Printer* p);
+  void GenerateJsonMethods(io::Printer* p);
   bool NeedsIsInitialized();
 
   struct NewOpRequirements {
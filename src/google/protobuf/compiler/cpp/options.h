@@ -66,6 +66,7 @@ struct Options {
   bool force_inline_string = false;
 #endif  // !PROTOBUF_STABLE_EXPERIMENTS
   bool strip_nonfunctional_codegen = false;
+  bool json_codegen = false;
 };
 
 }  // namespace cpp
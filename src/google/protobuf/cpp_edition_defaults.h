@@ -5,7 +5,7 @@
 // the C++ runtime.  This is used for feature resolution under Editions.
 // NOLINTBEGIN
 // clang-format off
-#define PROTOBUF_INTERNAL_CPP_EDITION_DEFAULTS "\n\037\030\204\007\"\003\302>\000*\025\010\001\020\002\030\002 \003(\0010\002\302>\006\010\001\020\003\030\000\n\037\030\347\007\"\003\302>\000*\025\010\002\020\001\030\001 \002(\0010\001\302>\006\010\000\020\003\030\000\n\037\030\350\007\"\023\010\001\020\001\030\001 \002(\0010\001\302>\004\010\000\020\003*\005\302>\002\030\000\n\037\030\351\007\"\025\010\001\020\001\030\001 \002(\0010\001\302>\006\010\000\020\001\030\001*\003\302>\000 \346\007(\351\007"
+#define PROTOBUF_INTERNAL_CPP_EDITION_DEFAULTS "\n!\030\204\007\"\003\302>\000*\027\010\001\020\002\030\002 \003(\0010\002\302>\010\010\001\020\003\030\000 \000\n!\030\347\007\"\003\302>\000*\027\010\002\020\001\030\001 \002(\0010\001\302>\010\010\000\020\003\030\000 \000\n!\030\350\007\"\025\010\001\020\001\030\001 \002(\0010\001\302>\006\010\000\020\003 \000*\005\302>\002\030\000\n!\030\351\007\"\027\010\001\020\001\030\001 \002(\0010\001\302>\010\010\000\020\001\030\001 \000*\003\302>\000 \346\007(\351\007"
 // clang-format on
 // NOLINTEND
 
@@ -31,7 +31,8 @@ inline constexpr CppFeatures::Impl_::Impl_(
       : _cached_size_{0},
         string_type_{static_cast< ::pb::CppFeatures_StringType >(0)},
         legacy_closed_enum_{false},
-        enum_name_uses_string_view_{false} {}
+        enum_name_uses_string_view_{false},
+        inline_string_{false} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR CppFeatures::CppFeatures(::_pbi::ConstantInitialized)
@@ -70,14 +71,16 @@ const ::uint32_t
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.legacy_closed_enum_),
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.string_type_),
         PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.enum_name_uses_string_view_),
+        PROTOBUF_FIELD_OFFSET(::pb::CppFeatures, _impl_.inline_string_),
         1,
         0,
         2,
+        3,
 };
 
 static const ::_pbi::MigrationSchema
     schemas[] ABSL_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
-        {0, 11, -1, sizeof(::pb::CppFeatures)},
+        {0, 12, -1, sizeof(::pb::CppFeatures)},
 };
 static const ::_pb::Message* const file_default_instances[] = {
     &::pb::_CppFeatures_default_instance_._instance,
@@ -85,7 +88,7 @@ static const ::_pb::Message* const file_default_instances[] = {
 const char descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto[] ABSL_ATTRIBUTE_SECTION_VARIABLE(
     protodesc_cold) = {
     "\n\"google/protobuf/cpp_features.proto\022\002pb"
-    "\032 google/protobuf/descriptor.proto\"\374\003\n\013C"
+    "\032 google/protobuf/descriptor.proto\"\264\004\n\013C"
     "ppFeatures\022\373\001\n\022legacy_closed_enum\030\001 \001(\010B"
     "\336\001\210\001\001\230\001\004\230\001\001\242\001\t\022\004true\030\204\007\242\001\n\022\005false\030\347\007\262\001\270\001"
     "\010\350\007\020\350\007\032\257\001The legacy closed enum behavior"
@@ -96,11 +99,12 @@ const char descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto[
     "\002 \001(\0162\032.pb.CppFeatures.StringTypeB)\210\001\001\230\001"
     "\004\230\001\001\242\001\013\022\006STRING\030\204\007\242\001\t\022\004VIEW\030\351\007\262\001\003\010\350\007\022L\n\032"
     "enum_name_uses_string_view\030\003 \001(\010B(\210\001\002\230\001\006"
-    "\230\001\001\242\001\n\022\005false\030\204\007\242\001\t\022\004true\030\351\007\262\001\003\010\351\007\"E\n\nSt"
-    "ringType\022\027\n\023STRING_TYPE_UNKNOWN\020\000\022\010\n\004VIE"
-    "W\020\001\022\010\n\004CORD\020\002\022\n\n\006STRING\020\003::\n\003cpp\022\033.googl"
-    "e.protobuf.FeatureSet\030\350\007 \001(\0132\017.pb.CppFea"
-    "tures"
+    "\230\001\001\242\001\n\022\005false\030\204\007\242\001\t\022\004true\030\351\007\262\001\003\010\351\007\0226\n\rin"
+    "line_string\030\004 \001(\010B\037\210\001\002\230\001\004\230\001\003\230\001\001\242\001\n\022\005fals"
+    "e\030\204\007\262\001\003\010\350\007\"E\n\nStringType\022\027\n\023STRING_TYPE_"
+    "UNKNOWN\020\000\022\010\n\004VIEW\020\001\022\010\n\004CORD\020\002\022\n\n\006STRING\020"
+    "\003::\n\003cpp\022\033.google.protobuf.FeatureSet\030\350\007"
+    " \001(\0132\017.pb.CppFeatures"
 };
 static const ::_pbi::DescriptorTable* const descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto_deps[1] =
     {
@@ -110,7 +114,7 @@ static ::absl::once_flag descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2ep
 PROTOBUF_CONSTINIT const ::_pbi::DescriptorTable descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto = {
     false,
     false,
-    645,
+    701,
     descriptor_table_protodef_google_2fprotobuf_2fcpp_5ffeatures_2eproto,
     "google/protobuf/cpp_features.proto",
     &descriptor_table_google_2fprotobuf_2fcpp_5ffeatures_2eproto_once,
@@ -180,9 +184,9 @@ inline void CppFeatures::SharedCtor(::_pb::Arena* arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, string_type_),
            0,
-           offsetof(Impl_, enum_name_uses_string_view_) -
+           offsetof(Impl_, inline_string_) -
                offsetof(Impl_, string_type_) +
-               sizeof(Impl_::enum_name_uses_string_view_));
+               sizeof(Impl_::inline_string_));
 }
 CppFeatures::~CppFeatures() {
   // @@protoc_insertion_point(destructor:pb.CppFeatures)
@@ -237,15 +241,15 @@ const ::google::protobuf::internal::ClassData* CppFeatures::GetClassData() const
   return CppFeatures_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<2, 3, 1, 0, 2> CppFeatures::_table_ = {
+const ::_pbi::TcParseTable<2, 4, 1, 0, 2> CppFeatures::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_._has_bits_),
     0, // no _extensions_
-    3, 24,  // max_field_number, fast_idx_mask
+    4, 24,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967288,  // skipmap
+    4294967280,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    3,  // num_field_entries
+    4,  // num_field_entries
     1,  // num_aux_entries
     offsetof(decltype(_table_), aux_entries),
     CppFeatures_class_data_.base(),
@@ -255,7 +259,9 @@ const ::_pbi::TcParseTable<2, 3, 1, 0, 2> CppFeatures::_table_ = {
     ::_pbi::TcParser::GetTable<::pb::CppFeatures>(),  // to_prefetch
     #endif  // PROTOBUF_PREFETCH_PARSE_TABLE
   }, {{
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+    {::_pbi::TcParser::SingularVarintNoZag1<bool, offsetof(CppFeatures, _impl_.inline_string_), 3>(),
+     {32, 3, 0, PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.inline_string_)}},
     // optional bool legacy_closed_enum = 1 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
     {::_pbi::TcParser::SingularVarintNoZag1<bool, offsetof(CppFeatures, _impl_.legacy_closed_enum_), 1>(),
      {8, 1, 0, PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.legacy_closed_enum_)}},
@@ -277,6 +283,9 @@ const ::_pbi::TcParseTable<2, 3, 1, 0, 2> CppFeatures::_table_ = {
     // optional bool enum_name_uses_string_view = 3 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_ENUM, targets = TARGET_TYPE_FILE, edition_defaults = {
     {PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.enum_name_uses_string_view_), _Internal::kHasBitsOffset + 2, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kBool)},
+    // optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+    {PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.inline_string_), _Internal::kHasBitsOffset + 3, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kBool)},
   }}, {{
     {0, 4},
   }}, {{
@@ -291,10 +300,10 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _impl_._has_bits_[0];
-  if (cached_has_bits & 0x00000007u) {
+  if (cached_has_bits & 0x0000000fu) {
     ::memset(&_impl_.string_type_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.enum_name_uses_string_view_) -
-        reinterpret_cast<char*>(&_impl_.string_type_)) + sizeof(_impl_.enum_name_uses_string_view_));
+        reinterpret_cast<char*>(&_impl_.inline_string_) -
+        reinterpret_cast<char*>(&_impl_.string_type_)) + sizeof(_impl_.inline_string_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -337,6 +346,13 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
                 3, this_._internal_enum_name_uses_string_view(), target);
           }
 
+          // optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+          if (cached_has_bits & 0x00000008u) {
+            target = stream->EnsureSpace(target);
+            target = ::_pbi::WireFormatLite::WriteBoolToArray(
+                4, this_._internal_inline_string(), target);
+          }
+
           if (PROTOBUF_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
             target =
                 ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -362,7 +378,7 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
 
           ::_pbi::Prefetch5LinesFrom7Lines(&this_);
           cached_has_bits = this_._impl_._has_bits_[0];
-          if (cached_has_bits & 0x00000007u) {
+          if (cached_has_bits & 0x0000000fu) {
             // optional .pb.CppFeatures.StringType string_type = 2 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
             if (cached_has_bits & 0x00000001u) {
               total_size += 1 +
@@ -376,6 +392,10 @@ PROTOBUF_NOINLINE void CppFeatures::Clear() {
             if (cached_has_bits & 0x00000004u) {
               total_size += 2;
             }
+            // optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+            if (cached_has_bits & 0x00000008u) {
+              total_size += 2;
+            }
           }
           return this_.MaybeComputeUnknownFieldsSize(total_size,
                                                      &this_._impl_._cached_size_);
@@ -390,7 +410,7 @@ void CppFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if (cached_has_bits & 0x00000007u) {
+  if (cached_has_bits & 0x0000000fu) {
     if (cached_has_bits & 0x00000001u) {
       _this->_impl_.string_type_ = from._impl_.string_type_;
     }
@@ -400,6 +420,9 @@ void CppFeatures::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
     if (cached_has_bits & 0x00000004u) {
       _this->_impl_.enum_name_uses_string_view_ = from._impl_.enum_name_uses_string_view_;
     }
+    if (cached_has_bits & 0x00000008u) {
+      _this->_impl_.inline_string_ = from._impl_.inline_string_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -418,8 +441,8 @@ void CppFeatures::InternalSwap(CppFeatures* PROTOBUF_RESTRICT other) {
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.enum_name_uses_string_view_)
-      + sizeof(CppFeatures::_impl_.enum_name_uses_string_view_)
+      PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.inline_string_)
+      + sizeof(CppFeatures::_impl_.inline_string_)
       - PROTOBUF_FIELD_OFFSET(CppFeatures, _impl_.string_type_)>(
           reinterpret_cast<char*>(&_impl_.string_type_),
           reinterpret_cast<char*>(&other->_impl_.string_type_));
@@ -274,6 +274,7 @@ class PROTOBUF_EXPORT CppFeatures final
     kStringTypeFieldNumber = 2,
     kLegacyClosedEnumFieldNumber = 1,
     kEnumNameUsesStringViewFieldNumber = 3,
+    kInlineStringFieldNumber = 4,
   };
   // optional .pb.CppFeatures.StringType string_type = 2 [retention = RETENTION_RUNTIME, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_FILE, edition_defaults = {
   bool has_string_type() const;
@@ -307,13 +308,24 @@ class PROTOBUF_EXPORT CppFeatures final
   bool _internal_enum_name_uses_string_view() const;
   void _internal_set_enum_name_uses_string_view(bool value);
 
+  public:
+  // optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+  bool has_inline_string() const;
+  void clear_inline_string() ;
+  bool inline_string() const;
+  void set_inline_string(bool value);
+
+  private:
+  bool _internal_inline_string() const;
+  void _internal_set_inline_string(bool value);
+
   public:
   // @@protoc_insertion_point(class_scope:pb.CppFeatures)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
   static const ::google::protobuf::internal::TcParseTable<
-      2, 3, 1,
+      2, 4, 1,
       0, 2>
       _table_;
 
@@ -336,6 +348,7 @@ class PROTOBUF_EXPORT CppFeatures final
     int string_type_;
     bool legacy_closed_enum_;
     bool enum_name_uses_string_view_;
+    bool inline_string_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -450,6 +463,34 @@ inline void CppFeatures::_internal_set_enum_name_uses_string_view(bool value) {
   _impl_.enum_name_uses_string_view_ = value;
 }
 
+// optional bool inline_string = 4 [retention = RETENTION_SOURCE, targets = TARGET_TYPE_FIELD, targets = TARGET_TYPE_MESSAGE, targets = TARGET_TYPE_FILE, edition_defaults = {
+inline bool CppFeatures::has_inline_string() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline void CppFeatures::clear_inline_string() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.inline_string_ = false;
+  _impl_._has_bits_[0] &= ~0x00000008u;
+}
+inline bool CppFeatures::inline_string() const {
+  // @@protoc_insertion_point(field_get:pb.CppFeatures.inline_string)
+  return _internal_inline_string();
+}
+inline void CppFeatures::set_inline_string(bool value) {
+  _internal_set_inline_string(value);
+  _impl_._has_bits_[0] |= 0x00000008u;
+  // @@protoc_insertion_point(field_set:pb.CppFeatures.inline_string)
+}
+inline bool CppFeatures::_internal_inline_string() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return _impl_.inline_string_;
+}
+inline void CppFeatures::_internal_set_inline_string(bool value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.inline_string_ = value;
+}
+
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif  // __GNUC__
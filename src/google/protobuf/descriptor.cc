@@ -298,8 +298,6 @@ class FlatAllocation {
     return out;
   }
 
-
- private:
   // Total number of bytes used by all arrays.
   int total_bytes() const {
     // Get the last end.
@@ -307,7 +305,7 @@ class FlatAllocation {
         sizeof...(T) - 1, std::tuple<T...>>::type>();
   }
 
-
+ private:
   template <typename U>
   int BeginOffset() const {
     constexpr int type_index = FindTypeIndex<U, T...>();
@@ -1070,6 +1068,116 @@ using EnumValuesByNumberSet =
 // for that.
 using ExtensionsGroupedByDescriptorMap =
     absl::btree_map<std::pair<const Descriptor*, int>, const FieldDescriptor*>;
+
+// An insert-only open-addressing hash set whose Find() may run concurrently
+// with Insert() without any locking.  Calls to Insert() must be externally
+// serialized; DescriptorPool does this with its mutex.
+//
+// The writer only ever fills empty slots, using release stores, so a reader
+// sees either an empty slot or a fully constructed element.  Growing builds a
+// larger slot array and then publishes it.  Superseded arrays stay alive until
+// the set is destroyed because a reader may still be probing them.  Capacity
+// doubles on each growth, so the retired arrays never take more memory in
+// total than the live one.
+//
+// `Traits` provides `Empty()`, `IsEmpty(T)`, `KeyOf(T)`, `Hash(Key)` and
+// `Matches(T, Key)`.
+template <typename T, typename Traits>
+class ConcurrentInsertOnlySet {
+ public:
+  ConcurrentInsertOnlySet() = default;
+  ConcurrentInsertOnlySet(const ConcurrentInsertOnlySet&) = delete;
+  ConcurrentInsertOnlySet& operator=(const ConcurrentInsertOnlySet&) = delete;
+
+  template <typename Key>
+  T Find(const Key& key) const {
+    const Slots* slots = current_.load(std::memory_order_acquire);
+    if (slots == nullptr) return Traits::Empty();
+    for (size_t i = Traits::Hash(key) & slots->mask;;
+         i = (i + 1) & slots->mask) {
+      T value = slots->values[i].load(std::memory_order_acquire);
+      if (Traits::IsEmpty(value) || Traits::Matches(value, key)) return value;
+    }
+  }
+
+  // `value` must not already be in the set.
+  void Insert(T value) {
+    if (all_slots_.empty() || 2 * (size_ + 1) > all_slots_.back()->mask + 1) {
+      Grow();
+    }
+    InsertNoGrow(*all_slots_.back(), value, std::memory_order_release);
+    ++size_;
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 16;
+
+  struct Slots {
+    explicit Slots(size_t capacity)
+        : mask(capacity - 1), values(new std::atomic<T>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) {
+        values[i].store(Traits::Empty(), std::memory_order_relaxed);
+      }
+    }
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> values;
+  };
+
+  static void InsertNoGrow(Slots& slots, T value, std::memory_order order) {
+    for (size_t i = Traits::Hash(Traits::KeyOf(value)) & slots.mask;;
+         i = (i + 1) & slots.mask) {
+      if (Traits::IsEmpty(slots.values[i].load(std::memory_order_relaxed))) {
+        slots.values[i].store(value, order);
+        return;
+      }
+    }
+  }
+
+  void Grow() {
+    const size_t capacity =
+        all_slots_.empty() ? kMinCapacity : 2 * (all_slots_.back()->mask + 1);
+    auto grown = absl::make_unique<Slots>(capacity);
+    if (!all_slots_.empty()) {
+      const Slots& old = *all_slots_.back();
+      for (size_t i = 0; i <= old.mask; ++i) {
+        T value = old.values[i].load(std::memory_order_relaxed);
+        if (!Traits::IsEmpty(value)) {
+          InsertNoGrow(*grown, value, std::memory_order_relaxed);
+        }
+      }
+    }
+    // Publishing the array releases all of the relaxed stores above.
+    current_.store(grown.get(), std::memory_order_release);
+    all_slots_.push_back(std::move(grown));
+  }
+
+  std::atomic<const Slots*> current_{nullptr};
+  std::vector<std::unique_ptr<Slots>> all_slots_;
+  size_t size_ = 0;
+};
+
+struct PublishedSymbolTraits {
+  static Symbol Empty() { return Symbol(); }
+  static bool IsEmpty(Symbol symbol) { return symbol.IsNull(); }
+  static absl::string_view KeyOf(Symbol symbol) { return symbol.full_name(); }
+  static size_t Hash(absl::string_view name) { return absl::HashOf(name); }
+  static bool Matches(Symbol symbol, absl::string_view name) {
+    return symbol.full_name() == name;
+  }
+};
+
+struct PublishedExtensionTraits {
+  using Key = std::pair<const Descriptor*, int>;
+  static const FieldDescriptor* Empty() { return nullptr; }
+  static bool IsEmpty(const FieldDescriptor* field) { return field == nullptr; }
+  static Key KeyOf(const FieldDescriptor* field) {
+    return {field->containing_type(), field->number()};
+  }
+  static size_t Hash(const Key& key) { return absl::HashOf(key); }
+  static bool Matches(const FieldDescriptor* field, const Key& key) {
+    return KeyOf(field) == key;
+  }
+};
 using LocationsByPathMap =
     absl::flat_hash_map<std::string, const SourceCodeInfo_Location*>;
 
@@ -1239,6 +1347,8 @@ class FileDescriptorTables {
       const void* parent, absl::string_view lowercase_name) const;
   inline const FieldDescriptor* FindFieldByCamelcaseName(
       const void* parent, absl::string_view camelcase_name) const;
+  inline const FieldDescriptor* FindFieldByJsonName(
+      const Descriptor* parent, absl::string_view name) const;
   inline const EnumValueDescriptor* FindEnumValueByNumber(
       const EnumDescriptor* parent, int number) const;
   // This creates a new EnumValueDescriptor if not found, in a thread-safe way.
@@ -1279,15 +1389,20 @@ class FileDescriptorTables {
   static void FieldsByCamelcaseNamesLazyInitStatic(
       const FileDescriptorTables* tables);
   void FieldsByCamelcaseNamesLazyInitInternal() const;
+  static void FieldsByJsonNamesLazyInitStatic(
+      const FileDescriptorTables* tables);
+  void FieldsByJsonNamesLazyInitInternal() const;
 
   SymbolsByParentSet symbols_by_parent_;
   mutable absl::once_flag fields_by_lowercase_name_once_;
   mutable absl::once_flag fields_by_camelcase_name_once_;
+  mutable absl::once_flag fields_by_json_name_once_;
   // Make these fields atomic to avoid race conditions with
   // GetEstimatedOwnedMemoryBytesSize. Once the pointer is set the map won't
   // change anymore.
   mutable std::atomic<const FieldsByNameMap*> fields_by_lowercase_name_{};
   mutable std::atomic<const FieldsByNameMap*> fields_by_camelcase_name_{};
+  mutable std::atomic<const FieldsByNameMap*> fields_by_json_name_{};
   FieldsByNumberSet fields_by_number_;  // Not including extensions.
   EnumValuesByNumberSet enum_values_by_number_;
   mutable EnumValuesByNumberSet unknown_enum_values_by_number_
@@ -1507,6 +1622,22 @@ class DescriptorPool::Tables {
   // if not found.
   inline Symbol FindSymbol(absl::string_view key) const;
 
+  // Makes committed symbols and extensions visible to the Find*Published()
+  // methods below.  Only pools that are shared across threads (i.e. that have
+  // a mutex) need this.
+  void EnablePublishing() { publishing_enabled_ = true; }
+
+  // Like FindSymbol() and FindExtension(), but may be called without holding
+  // the pool mutex.  Only symbols from files that finished building are
+  // visible here; a miss must be retried under the mutex.
+  Symbol FindPublishedSymbol(absl::string_view key) const {
+    return published_symbols_.Find(key);
+  }
+  const FieldDescriptor* FindPublishedExtension(const Descriptor* extendee,
+                                                int number) const {
+    return published_extensions_.Find(std::make_pair(extendee, number));
+  }
+
   // This implements the body of DescriptorPool::Find*ByName().  It should
   // really be a private method of DescriptorPool, but that would require
   // declaring Symbol in descriptor.h, which would drag all kinds of other
@@ -1557,6 +1688,9 @@ class DescriptorPool::Tables {
   internal::FlatAllocator::Allocation* CreateFlatAlloc(
       const TypeMap<IntT, T...>& sizes);
 
+  // Returns the number of bytes held by the allocations above.
+  size_t SpaceUsed() const;
+
 
  private:
   // All memory allocated in the pool.  Must be first as other objects can
@@ -1580,6 +1714,14 @@ class DescriptorPool::Tables {
   DescriptorsByNameSet<FileDescriptor> files_by_name_;
   ExtensionsGroupedByDescriptorMap extensions_;
 
+  // Lock-free views of the committed entries of symbols_by_name_ and
+  // extensions_.  Entries are added when the outermost checkpoint is cleared,
+  // so rolled back symbols are never published.
+  bool publishing_enabled_ = false;
+  ConcurrentInsertOnlySet<Symbol, PublishedSymbolTraits> published_symbols_;
+  ConcurrentInsertOnlySet<const FieldDescriptor*, PublishedExtensionTraits>
+      published_extensions_;
+
   // A cache of all unique feature sets seen.  Since we expect this number to be
   // relatively low compared to descriptors, it's significantly cheaper to share
   // these within the pool than have each file create its own feature sets.
@@ -1638,6 +1780,7 @@ FileDescriptorTables::FileDescriptorTables() = default;
 FileDescriptorTables::~FileDescriptorTables() {
   delete fields_by_lowercase_name_.load(std::memory_order_acquire);
   delete fields_by_camelcase_name_.load(std::memory_order_acquire);
+  delete fields_by_json_name_.load(std::memory_order_acquire);
 }
 
 inline const FileDescriptorTables& FileDescriptorTables::GetEmptyInstance() {
@@ -1656,6 +1799,15 @@ void DescriptorPool::Tables::ClearLastCheckpoint() {
   if (checkpoints_.empty()) {
     // All checkpoints have been cleared: we can now commit all of the pending
     // data.
+    if (publishing_enabled_) {
+      for (Symbol symbol : symbols_after_checkpoint_) {
+        published_symbols_.Insert(symbol);
+      }
+      for (const auto& extension : extensions_after_checkpoint_) {
+        published_extensions_.Insert(
+            FindExtension(extension.first, extension.second));
+      }
+    }
     symbols_after_checkpoint_.clear();
     files_after_checkpoint_.clear();
     extensions_after_checkpoint_.clear();
@@ -1708,12 +1860,10 @@ inline Symbol FileDescriptorTables::FindNestedSymbol(
 Symbol DescriptorPool::Tables::FindByNameHelper(const DescriptorPool* pool,
                                                 absl::string_view name) {
   if (pool->mutex_ != nullptr) {
-    // Fast path: the Symbol is already cached.  This is just a hash lookup.
-    absl::ReaderMutexLock lock(pool->mutex_);
-    if (known_bad_symbols_.empty() && known_bad_files_.empty()) {
-      Symbol result = FindSymbol(name);
-      if (!result.IsNull()) return result;
-    }
+    // Fast path: the Symbol is already built.  This is a lock-free hash
+    // lookup, so concurrent readers don't contend on the mutex.
+    Symbol result = FindPublishedSymbol(name);
+    if (!result.IsNull()) return result;
   }
   DescriptorPool::DeferredValidation deferred_validation(pool);
   Symbol result;
@@ -1837,6 +1987,60 @@ inline const FieldDescriptor* FileDescriptorTables::FindFieldByCamelcaseName(
   return it->second;
 }
 
+void FileDescriptorTables::FieldsByJsonNamesLazyInitStatic(
+    const FileDescriptorTables* tables) {
+  tables->FieldsByJsonNamesLazyInitInternal();
+}
+
+void FileDescriptorTables::FieldsByJsonNamesLazyInitInternal() const {
+  // Resolve camel-case collisions exactly like FindFieldByCamelcaseName(),
+  // extensions included. A camel-case name won by an extension is left to
+  // the lookups by name and json_name below.
+  FieldsByNameMap camelcase;
+  absl::flat_hash_set<const Descriptor*> parents;
+  for (Symbol symbol : symbols_by_parent_) {
+    const FieldDescriptor* field = symbol.field_descriptor();
+    if (!field) continue;
+    const FieldDescriptor*& found =
+        camelcase[{FindParentForFieldsByMap(field), field->camelcase_name()}];
+    if (found == nullptr || found->number() > field->number()) {
+      found = field;
+    }
+    if (!field->is_extension()) parents.insert(field->containing_type());
+  }
+
+  auto* map = new FieldsByNameMap;
+  for (const auto& entry : camelcase) {
+    if (!entry.second->is_extension()) map->insert(entry);
+  }
+  // try_emplace() keeps keys that are already taken, which gives camel-case
+  // names precedence over names, and names over custom json_names. Among
+  // json_names, the field declared first wins.
+  for (const Descriptor* parent : parents) {
+    for (int i = 0; i < parent->field_count(); ++i) {
+      const FieldDescriptor* field = parent->field(i);
+      map->try_emplace({parent, field->name()}, field);
+    }
+    for (int i = 0; i < parent->field_count(); ++i) {
+      const FieldDescriptor* field = parent->field(i);
+      if (field->has_json_name()) {
+        map->try_emplace({parent, field->json_name()}, field);
+      }
+    }
+  }
+  fields_by_json_name_.store(map, std::memory_order_release);
+}
+
+inline const FieldDescriptor* FileDescriptorTables::FindFieldByJsonName(
+    const Descriptor* parent, absl::string_view name) const {
+  absl::call_once(fields_by_json_name_once_,
+                  FileDescriptorTables::FieldsByJsonNamesLazyInitStatic, this);
+  auto* fields = fields_by_json_name_.load(std::memory_order_acquire);
+  auto it = fields->find({parent, name});
+  if (it == fields->end()) return nullptr;
+  return it->second;
+}
+
 inline const EnumValueDescriptor* FileDescriptorTables::FindEnumValueByNumber(
     const EnumDescriptor* parent, int number) const {
   // If `number` is within the sequential range, just index into the parent
@@ -2026,6 +2230,17 @@ void* DescriptorPool::Tables::AllocateBytes(int size) {
   return static_cast<char*>(p) + RoundUpTo<8>(sizeof(int));
 }
 
+size_t DescriptorPool::Tables::SpaceUsed() const {
+  size_t total = 0;
+  for (const auto& alloc : misc_allocs_) {
+    total += *alloc + RoundUpTo<8>(sizeof(int));
+  }
+  for (const auto& alloc : flat_allocs_) {
+    total += alloc->total_bytes();
+  }
+  return total;
+}
+
 template <typename... T>
 internal::FlatAllocator::Allocation* DescriptorPool::Tables::CreateFlatAlloc(
     const TypeMap<IntT, T...>& sizes) {
@@ -2125,7 +2340,9 @@ DescriptorPool::DescriptorPool(DescriptorDatabase* fallback_database,
       enforce_weak_(false),
       enforce_extension_declarations_(false),
       disallow_enforce_utf8_(false),
-      deprecated_legacy_json_field_conflicts_(false) {}
+      deprecated_legacy_json_field_conflicts_(false) {
+  tables_->EnablePublishing();
+}
 
 DescriptorPool::DescriptorPool(const DescriptorPool* underlay)
     : mutex_(nullptr),
@@ -2182,6 +2399,11 @@ bool DescriptorPool::InternalIsFileLoaded(absl::string_view filename) const {
   return tables_->FindFile(filename) != nullptr;
 }
 
+size_t DescriptorPool::InternalSpaceUsed() const {
+  absl::MutexLockMaybe lock(mutex_);
+  return tables_->SpaceUsed();
+}
+
 // generated_pool ====================================================
 
 namespace {
@@ -2367,11 +2589,11 @@ const MethodDescriptor* DescriptorPool::FindMethodByName(
 const FieldDescriptor* DescriptorPool::FindExtensionByNumber(
     const Descriptor* extendee, int number) const {
   if (extendee->extension_range_count() == 0) return nullptr;
-  // A faster path to reduce lock contention in finding extensions, assuming
-  // most extensions will be cache hit.
+  // A lock-free fast path for extensions that are already built, assuming
+  // most lookups will be cache hits.
   if (mutex_ != nullptr) {
-    absl::ReaderMutexLock lock(mutex_);
-    const FieldDescriptor* result = tables_->FindExtension(extendee, number);
+    const FieldDescriptor* result =
+        tables_->FindPublishedExtension(extendee, number);
     if (result != nullptr) {
       return result;
     }
@@ -2521,6 +2743,11 @@ const FieldDescriptor* Descriptor::FindFieldByCamelcaseName(
   }
 }
 
+const FieldDescriptor* Descriptor::FindFieldByJsonName(
+    absl::string_view name) const {
+  return file()->tables_->FindFieldByJsonName(this, name);
+}
+
 const FieldDescriptor* Descriptor::FindFieldByName(
     absl::string_view name) const {
   const FieldDescriptor* field =
@@ -4353,6 +4580,12 @@ class DescriptorBuilder {
   void AddPackage(absl::string_view name, const Message& proto,
                   FileDescriptor* file, bool toplevel);
 
+  // Returns an existing copy of the package name of `proto` that the new file
+  // can point to instead of allocating its own, or nullptr if there is none.
+  // Files without a package share the global empty string, and files in a
+  // package that is already in the pool share the first file's string.
+  const std::string* FindSharedPackage(const FileDescriptorProto& proto) const;
+
   // Checks that the symbol name contains only alphanumeric characters and
   // underscores.  Records an error otherwise.
   void ValidateSymbolName(absl::string_view name, absl::string_view full_name,
@@ -5321,6 +5554,22 @@ bool DescriptorBuilder::AddSymbol(const absl::string_view full_name,
   }
 }
 
+const std::string* DescriptorBuilder::FindSharedPackage(
+    const FileDescriptorProto& proto) const {
+  // We cannot rely on proto.package() returning a valid string if
+  // proto.has_package() is false, because we might be running at static
+  // initialization time, in which case default values have not yet been
+  // initialized.
+  if (!proto.has_package() || proto.package().empty()) {
+    return &internal::GetEmptyString();
+  }
+  // Everything added to the tables since this file's checkpoint is rolled
+  // back together with it, so the string outlives the new file.
+  const FileDescriptor* other = tables_->FindSymbol(proto.package())
+                                    .file_descriptor();
+  return other != nullptr ? &other->package() : nullptr;
+}
+
 void DescriptorBuilder::AddPackage(const absl::string_view name,
                                    const Message& proto, FileDescriptor* file,
                                    bool toplevel) {
@@ -5799,10 +6048,11 @@ static void PlanAllocationSize(
 }
 
 static void PlanAllocationSize(const FileDescriptorProto& proto,
+                               bool shared_package,
                                internal::FlatAllocator& alloc) {
   alloc.PlanArray<FileDescriptor>(1);
   alloc.PlanArray<FileDescriptorTables>(1);
-  alloc.PlanArray<std::string>(2);  // name + package
+  alloc.PlanArray<std::string>(shared_package ? 1 : 2);  // name + package
   if (proto.has_options()) alloc.PlanArray<FileOptions>(1);
   if (proto.has_source_code_info()) alloc.PlanArray<SourceCodeInfo>(1);
 
@@ -5892,14 +6142,16 @@ const FileDescriptor* DescriptorBuilder::BuildFile(
   tables_->AddCheckpoint();
 
   auto alloc = absl::make_unique<internal::FlatAllocator>();
-  PlanAllocationSize(proto, *alloc);
+  PlanAllocationSize(proto, FindSharedPackage(proto) != nullptr, *alloc);
   alloc->FinalizePlanning(tables_);
   FileDescriptor* result = BuildFileImpl(proto, *alloc);
 
   file_tables_->FinalizeTables();
   if (result) {
-    tables_->ClearLastCheckpoint();
+    // Mark the file finished before clearing the checkpoint, which may publish
+    // its symbols to lock-free readers.
     result->finished_building_ = true;
+    tables_->ClearLastCheckpoint();
     alloc->ExpectConsumed();
   } else {
     tables_->RollbackToLastCheckpoint(deferred_validation_);
@@ -5960,14 +6212,9 @@ FileDescriptor* DescriptorBuilder::BuildFileImpl(
   }
 
   result->name_ = alloc.AllocateStrings(proto.name());
-  if (proto.has_package()) {
+  result->package_ = FindSharedPackage(proto);
+  if (result->package_ == nullptr) {
     result->package_ = alloc.AllocateStrings(proto.package());
-  } else {
-    // We cannot rely on proto.package() returning a valid string if
-    // proto.has_package() is false, because we might be running at static
-    // initialization time, in which case default values have not yet been
-    // initialized.
-    result->package_ = alloc.AllocateStrings("");
   }
   result->pool_ = pool_;
 
@@ -431,6 +431,13 @@ class PROTOBUF_EXPORT Descriptor : private internal::SymbolBase {
   const FieldDescriptor* FindFieldByCamelcaseName(
       absl::string_view camelcase_name) const;
 
+  // Looks up a field by any of the names accepted for it when parsing JSON:
+  // its camel-case name, its name, or its json_name when set explicitly.  If
+  // a name matches several fields, the camel-case name takes precedence over
+  // the name, which takes precedence over the json_name.  Returns nullptr if
+  // no such field exists.  Extensions are not considered.
+  const FieldDescriptor* FindFieldByJsonName(absl::string_view name) const;
+
   // The number of oneofs in this message type.
   int oneof_decl_count() const;
   // The number of oneofs in this message type, excluding synthetic oneofs.
@@ -2370,6 +2377,12 @@ class PROTOBUF_EXPORT DescriptorPool {
   // lazy descriptor initialization behavior.
   bool InternalIsFileLoaded(absl::string_view filename) const;
 
+  // For internal use only:  Returns the number of bytes this pool (but not its
+  // underlay) has allocated to hold descriptors and their names and options.
+  // Heap memory owned by those strings and options and the lookup tables are
+  // not included.  Used to track the memory cost of descriptors.
+  size_t InternalSpaceUsed() const;
+
   // Add a file to to apply more strict checks to.
   // - unused imports will log either warnings or errors.
   // - deprecated features will log warnings.
@@ -13,7 +13,10 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -23,7 +26,10 @@
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.pb.h"
+#include "google/protobuf/endian.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/parse_context.h"
+#include "google/protobuf/wire_format_lite.h"
 
 
 namespace google {
@@ -543,10 +549,197 @@ class EncodedDescriptorDatabase::DescriptorIndex {
   std::vector<ExtensionEntry> by_extension_flat_;
 };
 
+namespace {
+
+// The parts of a FileDescriptorProto that EncodedDescriptorDatabase indexes,
+// with the same accessors as the generated classes so that they can be passed
+// to DescriptorIndex::AddFile().  Strings are views into the encoded bytes.
+// Decoding only these fields lets Add() skip over everything else in the file
+// (fields, options, source code info, ...) rather than parsing all of it.
+struct IndexFieldProto {
+  absl::string_view name_;
+  absl::string_view extendee_;
+  int number_ = 0;
+
+  absl::string_view name() const { return name_; }
+  absl::string_view extendee() const { return extendee_; }
+  int number() const { return number_; }
+};
+
+struct IndexNamedProto {
+  absl::string_view name_;
+
+  absl::string_view name() const { return name_; }
+};
+
+struct IndexMessageProto {
+  absl::string_view name_;
+  std::vector<IndexMessageProto> nested_type_;
+  std::vector<IndexFieldProto> extension_;
+
+  absl::string_view name() const { return name_; }
+  const std::vector<IndexMessageProto>& nested_type() const {
+    return nested_type_;
+  }
+  const std::vector<IndexFieldProto>& extension() const { return extension_; }
+};
+
+struct IndexFileProto {
+  absl::string_view name_;
+  absl::string_view package_;
+  std::vector<IndexMessageProto> message_type_;
+  std::vector<IndexNamedProto> enum_type_;
+  std::vector<IndexFieldProto> extension_;
+  std::vector<IndexNamedProto> service_;
+
+  absl::string_view name() const { return name_; }
+  absl::string_view package() const { return package_; }
+  const std::vector<IndexMessageProto>& message_type() const {
+    return message_type_;
+  }
+  const std::vector<IndexNamedProto>& enum_type() const { return enum_type_; }
+  const std::vector<IndexFieldProto>& extension() const { return extension_; }
+  const std::vector<IndexNamedProto>& service() const { return service_; }
+};
+
+using internal::WireFormatLite;
+
+// Reads a length-delimited field as a view into the array `input` reads from.
+bool ReadStringView(io::CodedInputStream* input, absl::string_view* output) {
+  int length;
+  if (!input->ReadVarintSizeAsInt(&length)) return false;
+  if (length == 0) {
+    *output = absl::string_view();
+    return true;
+  }
+  const void* data;
+  int size;
+  if (!input->GetDirectBufferPointer(&data, &size) || size < length) {
+    return false;
+  }
+  *output = absl::string_view(static_cast<const char*>(data), length);
+  return input->Skip(length);
+}
+
+// Decodes a length-delimited submessage by passing each of its tags to
+// `handle_tag`, which must consume the field's value.
+template <typename HandleTag>
+bool DecodeSubmessage(io::CodedInputStream* input, HandleTag handle_tag) {
+  int length;
+  if (!input->ReadVarintSizeAsInt(&length)) return false;
+  auto limit = input->IncrementRecursionDepthAndPushLimit(length);
+  if (limit.second < 0) return false;
+  while (uint32_t tag = input->ReadTag()) {
+    if (!handle_tag(tag)) return false;
+  }
+  return input->DecrementRecursionDepthAndPopLimit(limit.first);
+}
+
+bool IsLengthDelimited(uint32_t tag) {
+  return WireFormatLite::GetTagWireType(tag) ==
+         WireFormatLite::WIRETYPE_LENGTH_DELIMITED;
+}
+
+bool DecodeField(io::CodedInputStream* input, IndexFieldProto* field) {
+  return DecodeSubmessage(input, [&](uint32_t tag) {
+    switch (WireFormatLite::GetTagFieldNumber(tag)) {
+      case FieldDescriptorProto::kNameFieldNumber:
+        if (IsLengthDelimited(tag)) return ReadStringView(input, &field->name_);
+        break;
+      case FieldDescriptorProto::kExtendeeFieldNumber:
+        if (IsLengthDelimited(tag)) {
+          return ReadStringView(input, &field->extendee_);
+        }
+        break;
+      case FieldDescriptorProto::kNumberFieldNumber:
+        if (WireFormatLite::GetTagWireType(tag) ==
+            WireFormatLite::WIRETYPE_VARINT) {
+          uint32_t number;
+          if (!input->ReadVarint32(&number)) return false;
+          field->number_ = static_cast<int>(number);
+          return true;
+        }
+        break;
+    }
+    return WireFormatLite::SkipField(input, tag);
+  });
+}
+
+// Decodes any of the descriptor protos whose name is field 1.
+bool DecodeNamed(io::CodedInputStream* input, IndexNamedProto* named) {
+  return DecodeSubmessage(input, [&](uint32_t tag) {
+    if (tag == WireFormatLite::MakeTag(
+                   1, WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+      return ReadStringView(input, &named->name_);
+    }
+    return WireFormatLite::SkipField(input, tag);
+  });
+}
+
+bool DecodeMessage(io::CodedInputStream* input, IndexMessageProto* message) {
+  return DecodeSubmessage(input, [&](uint32_t tag) {
+    if (IsLengthDelimited(tag)) {
+      switch (WireFormatLite::GetTagFieldNumber(tag)) {
+        case DescriptorProto::kNameFieldNumber:
+          return ReadStringView(input, &message->name_);
+        case DescriptorProto::kNestedTypeFieldNumber:
+          message->nested_type_.emplace_back();
+          return DecodeMessage(input, &message->nested_type_.back());
+        case DescriptorProto::kExtensionFieldNumber:
+          message->extension_.emplace_back();
+          return DecodeField(input, &message->extension_.back());
+      }
+    }
+    return WireFormatLite::SkipField(input, tag);
+  });
+}
+
+bool DecodeFile(const void* data, int size, IndexFileProto* file) {
+  io::CodedInputStream input(static_cast<const uint8_t*>(data), size);
+  while (uint32_t tag = input.ReadTag()) {
+    bool ok;
+    if (!IsLengthDelimited(tag)) {
+      ok = WireFormatLite::SkipField(&input, tag);
+    } else {
+      switch (WireFormatLite::GetTagFieldNumber(tag)) {
+        case FileDescriptorProto::kNameFieldNumber:
+          ok = ReadStringView(&input, &file->name_);
+          break;
+        case FileDescriptorProto::kPackageFieldNumber:
+          ok = ReadStringView(&input, &file->package_);
+          break;
+        case FileDescriptorProto::kMessageTypeFieldNumber:
+          file->message_type_.emplace_back();
+          ok = DecodeMessage(&input, &file->message_type_.back());
+          break;
+        case FileDescriptorProto::kEnumTypeFieldNumber:
+          file->enum_type_.emplace_back();
+          ok = DecodeNamed(&input, &file->enum_type_.back());
+          break;
+        case FileDescriptorProto::kExtensionFieldNumber:
+          file->extension_.emplace_back();
+          ok = DecodeField(&input, &file->extension_.back());
+          break;
+        case FileDescriptorProto::kServiceFieldNumber:
+          file->service_.emplace_back();
+          ok = DecodeNamed(&input, &file->service_.back());
+          break;
+        default:
+          ok = WireFormatLite::SkipField(&input, tag);
+          break;
+      }
+    }
+    if (!ok) return false;
+  }
+  return input.ConsumedEntireMessage();
+}
+
+}  // namespace
+
 bool EncodedDescriptorDatabase::Add(const void* encoded_file_descriptor,
                                     int size) {
-  FileDescriptorProto file;
-  if (file.ParseFromArray(encoded_file_descriptor, size)) {
+  IndexFileProto file;
+  if (DecodeFile(encoded_file_descriptor, size, &file)) {
     return index_->AddFile(file, std::make_pair(encoded_file_descriptor, size));
   } else {
     ABSL_LOG(ERROR) << "Invalid file descriptor data passed to "
@@ -883,6 +1076,334 @@ EncodedDescriptorDatabase::~EncodedDescriptorDatabase() {
 
 // ===================================================================
 
+namespace {
+
+// Layout of a DescriptorImageDatabase image.  Every integer is a little-endian
+// uint32_t and every offset is relative to the start of the image, so the
+// image does not care where it is mapped.
+//
+//   header:      magic, file count, symbol count, extension count
+//   files:       {name offset, name size, data offset, data size},
+//                sorted by name
+//   symbols:     {name offset, name size, file index}, sorted by name
+//   extensions:  {extendee offset, extendee size, number, file index},
+//                sorted by (extendee, number)
+//   names and encoded FileDescriptorProtos referenced by the tables above
+//
+// As in SimpleDescriptorDatabase, the symbol table only holds top-level
+// symbols; nested symbols are found through their enclosing one.
+constexpr uint32_t kImageMagic = 0x31494450;  // "PDI1"
+constexpr uint32_t kImageHeaderSize = 4 * sizeof(uint32_t);
+constexpr uint32_t kImageFileEntrySize = 4 * sizeof(uint32_t);
+constexpr uint32_t kImageSymbolEntrySize = 3 * sizeof(uint32_t);
+constexpr uint32_t kImageExtensionEntrySize = 4 * sizeof(uint32_t);
+
+struct ImageSymbol {
+  std::string name;
+  uint32_t file;
+};
+
+struct ImageExtension {
+  std::string extendee;
+  uint32_t number;
+  uint32_t file;
+};
+
+void AddImageExtension(const FieldDescriptorProto& field, uint32_t file,
+                       std::vector<ImageExtension>* output) {
+  // Only fully-qualified extendees can be looked up; see
+  // SimpleDescriptorDatabase::DescriptorIndex::AddExtension().
+  if (!field.extendee().empty() && field.extendee()[0] == '.') {
+    output->push_back({field.extendee().substr(1),
+                       static_cast<uint32_t>(field.number()), file});
+  }
+}
+
+void AddImageNestedExtensions(const DescriptorProto& message_type,
+                              uint32_t file,
+                              std::vector<ImageExtension>* output) {
+  for (const DescriptorProto& nested : message_type.nested_type()) {
+    AddImageNestedExtensions(nested, file, output);
+  }
+  for (const FieldDescriptorProto& field : message_type.extension()) {
+    AddImageExtension(field, file, output);
+  }
+}
+
+// Returns the first index in [0, count) for which `less(index)` is false.
+// `less` must be true for a prefix of the range and false afterwards.
+template <typename Less>
+uint32_t ImageLowerBound(uint32_t count, Less less) {
+  uint32_t lo = 0;
+  uint32_t hi = count;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (less(mid)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+}  // namespace
+
+DescriptorImageDatabase::DescriptorImageDatabase() {}
+DescriptorImageDatabase::~DescriptorImageDatabase() {}
+
+bool DescriptorImageDatabase::BuildImage(const FileDescriptorSet& files,
+                                         std::string* output) {
+  // Reject exactly the inputs that SimpleDescriptorDatabase rejects, which
+  // also guarantees that the symbol and extension tables below are free of
+  // duplicates and of symbols nested in other symbols.
+  SimpleDescriptorDatabase validator;
+  for (const FileDescriptorProto& file : files.file()) {
+    if (!validator.AddUnowned(&file)) return false;
+  }
+
+  std::vector<const FileDescriptorProto*> sorted_files;
+  sorted_files.reserve(files.file_size());
+  for (const FileDescriptorProto& file : files.file()) {
+    sorted_files.push_back(&file);
+  }
+  std::sort(sorted_files.begin(), sorted_files.end(),
+            [](const FileDescriptorProto* a, const FileDescriptorProto* b) {
+              return a->name() < b->name();
+            });
+
+  std::vector<ImageSymbol> symbols;
+  std::vector<ImageExtension> extensions;
+  for (uint32_t i = 0; i < sorted_files.size(); ++i) {
+    const FileDescriptorProto& file = *sorted_files[i];
+    std::string path = file.has_package() ? file.package() : std::string();
+    if (!path.empty()) path += '.';
+
+    for (const DescriptorProto& message_type : file.message_type()) {
+      symbols.push_back({path + message_type.name(), i});
+      AddImageNestedExtensions(message_type, i, &extensions);
+    }
+    for (const EnumDescriptorProto& enum_type : file.enum_type()) {
+      symbols.push_back({path + enum_type.name(), i});
+    }
+    for (const FieldDescriptorProto& extension : file.extension()) {
+      symbols.push_back({path + extension.name(), i});
+      AddImageExtension(extension, i, &extensions);
+    }
+    for (const ServiceDescriptorProto& service : file.service()) {
+      symbols.push_back({path + service.name(), i});
+    }
+  }
+  std::sort(symbols.begin(), symbols.end(),
+            [](const ImageSymbol& a, const ImageSymbol& b) {
+              return a.name < b.name;
+            });
+  std::sort(extensions.begin(), extensions.end(),
+            [](const ImageExtension& a, const ImageExtension& b) {
+              return std::tie(a.extendee, a.number) <
+                     std::tie(b.extendee, b.number);
+            });
+
+  // Lay out the tables first, then append every referenced byte string after
+  // them, remembering where it landed.
+  const size_t data_start =
+      kImageHeaderSize + sorted_files.size() * kImageFileEntrySize +
+      symbols.size() * kImageSymbolEntrySize +
+      extensions.size() * kImageExtensionEntrySize;
+  std::vector<size_t> words = {kImageMagic, sorted_files.size(),
+                               symbols.size(), extensions.size()};
+  std::string data;
+  auto add_bytes = [&](absl::string_view bytes) {
+    words.push_back(data_start + data.size());
+    words.push_back(bytes.size());
+    data.append(bytes.data(), bytes.size());
+  };
+
+  std::string encoded;
+  for (const FileDescriptorProto* file : sorted_files) {
+    add_bytes(file->name());
+    encoded.clear();
+    file->SerializeToString(&encoded);
+    add_bytes(encoded);
+  }
+  for (const ImageSymbol& symbol : symbols) {
+    add_bytes(symbol.name);
+    words.push_back(symbol.file);
+  }
+  for (const ImageExtension& extension : extensions) {
+    add_bytes(extension.extendee);
+    words.push_back(extension.number);
+    words.push_back(extension.file);
+  }
+
+  if (data_start + data.size() > std::numeric_limits<uint32_t>::max()) {
+    ABSL_LOG(ERROR) << "Descriptor image would exceed 4GB.";
+    return false;
+  }
+
+  output->clear();
+  output->reserve(data_start + data.size());
+  for (size_t word : words) {
+    uint32_t value =
+        internal::little_endian::FromHost(static_cast<uint32_t>(word));
+    output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+  output->append(data);
+  return true;
+}
+
+bool DescriptorImageDatabase::Open(absl::string_view image) {
+  image_ = absl::string_view();
+  file_count_ = symbol_count_ = extension_count_ = 0;
+
+  if (image.size() < kImageHeaderSize ||
+      image.size() > std::numeric_limits<uint32_t>::max()) {
+    ABSL_LOG(ERROR) << "Invalid descriptor image size: " << image.size();
+    return false;
+  }
+  image_ = image;
+  const uint64_t file_count = Word(4);
+  const uint64_t symbol_count = Word(8);
+  const uint64_t extension_count = Word(12);
+  const uint64_t symbols_offset =
+      kImageHeaderSize + file_count * kImageFileEntrySize;
+  const uint64_t extensions_offset =
+      symbols_offset + symbol_count * kImageSymbolEntrySize;
+  if (Word(0) != kImageMagic ||
+      extensions_offset + extension_count * kImageExtensionEntrySize >
+          image.size()) {
+    ABSL_LOG(ERROR) << "Invalid descriptor image passed to "
+                       "DescriptorImageDatabase::Open().";
+    image_ = absl::string_view();
+    return false;
+  }
+
+  file_count_ = static_cast<uint32_t>(file_count);
+  symbol_count_ = static_cast<uint32_t>(symbol_count);
+  extension_count_ = static_cast<uint32_t>(extension_count);
+  symbols_offset_ = static_cast<uint32_t>(symbols_offset);
+  extensions_offset_ = static_cast<uint32_t>(extensions_offset);
+  return true;
+}
+
+uint32_t DescriptorImageDatabase::Word(uint32_t offset) const {
+  uint32_t value;
+  memcpy(&value, image_.data() + offset, sizeof(value));
+  return internal::little_endian::ToHost(value);
+}
+
+absl::string_view DescriptorImageDatabase::Bytes(uint32_t offset,
+                                                 uint32_t size) const {
+  // Open() only checks the tables, so bounds check the referenced bytes here
+  // rather than trusting the image.
+  if (offset > image_.size() || size > image_.size() - offset) return {};
+  return image_.substr(offset, size);
+}
+
+absl::string_view DescriptorImageDatabase::FileName(uint32_t index) const {
+  uint32_t entry = kImageHeaderSize + index * kImageFileEntrySize;
+  return Bytes(Word(entry), Word(entry + 4));
+}
+
+absl::string_view DescriptorImageDatabase::SymbolName(uint32_t index) const {
+  uint32_t entry = symbols_offset_ + index * kImageSymbolEntrySize;
+  return Bytes(Word(entry), Word(entry + 4));
+}
+
+absl::string_view DescriptorImageDatabase::ExtendeeName(uint32_t index) const {
+  uint32_t entry = extensions_offset_ + index * kImageExtensionEntrySize;
+  return Bytes(Word(entry), Word(entry + 4));
+}
+
+uint32_t DescriptorImageDatabase::ExtensionNumber(uint32_t index) const {
+  return Word(extensions_offset_ + index * kImageExtensionEntrySize + 8);
+}
+
+int64_t DescriptorImageDatabase::FindSymbolFile(
+    absl::string_view symbol_name) const {
+  // Same lookup as SimpleDescriptorDatabase::DescriptorIndex::FindSymbol():
+  // the last symbol sorting less than or equal to `symbol_name` is the only
+  // candidate that can contain it.
+  uint32_t index = ImageLowerBound(symbol_count_, [&](uint32_t i) {
+    return SymbolName(i) <= symbol_name;
+  });
+  if (index == 0) return -1;
+  --index;
+  if (!IsSubSymbol(SymbolName(index), symbol_name)) return -1;
+  return Word(symbols_offset_ + index * kImageSymbolEntrySize + 8);
+}
+
+uint32_t DescriptorImageDatabase::LowerBoundExtension(
+    absl::string_view extendee, uint32_t number) const {
+  return ImageLowerBound(extension_count_, [&](uint32_t i) {
+    absl::string_view entry_extendee = ExtendeeName(i);
+    return entry_extendee < extendee ||
+           (entry_extendee == extendee && ExtensionNumber(i) < number);
+  });
+}
+
+bool DescriptorImageDatabase::ParseFile(uint32_t index,
+                                        FileDescriptorProto* output) const {
+  if (index >= file_count_) return false;
+  uint32_t entry = kImageHeaderSize + index * kImageFileEntrySize;
+  absl::string_view data = Bytes(Word(entry + 8), Word(entry + 12));
+  // Every encoded file has at least a name, so an empty result means the
+  // entry pointed outside the image.
+  if (data.empty()) return false;
+  return internal::ParseNoReflection(data, *output);
+}
+
+bool DescriptorImageDatabase::FindFileByName(const std::string& filename,
+                                             FileDescriptorProto* output) {
+  uint32_t index = ImageLowerBound(
+      file_count_, [&](uint32_t i) { return FileName(i) < filename; });
+  if (index == file_count_ || FileName(index) != filename) return false;
+  return ParseFile(index, output);
+}
+
+bool DescriptorImageDatabase::FindFileContainingSymbol(
+    const std::string& symbol_name, FileDescriptorProto* output) {
+  int64_t file = FindSymbolFile(symbol_name);
+  return file >= 0 && ParseFile(static_cast<uint32_t>(file), output);
+}
+
+bool DescriptorImageDatabase::FindFileContainingExtension(
+    const std::string& containing_type, int field_number,
+    FileDescriptorProto* output) {
+  const uint32_t number = static_cast<uint32_t>(field_number);
+  uint32_t index = LowerBoundExtension(containing_type, number);
+  if (index == extension_count_ || ExtendeeName(index) != containing_type ||
+      ExtensionNumber(index) != number) {
+    return false;
+  }
+  return ParseFile(
+      Word(extensions_offset_ + index * kImageExtensionEntrySize + 12),
+      output);
+}
+
+bool DescriptorImageDatabase::FindAllExtensionNumbers(
+    const std::string& extendee_type, std::vector<int>* output) {
+  bool success = false;
+  for (uint32_t index = LowerBoundExtension(extendee_type, 0);
+       index < extension_count_ && ExtendeeName(index) == extendee_type;
+       ++index) {
+    output->push_back(static_cast<int>(ExtensionNumber(index)));
+    success = true;
+  }
+  return success;
+}
+
+bool DescriptorImageDatabase::FindAllFileNames(
+    std::vector<std::string>* output) {
+  output->resize(file_count_);
+  for (uint32_t i = 0; i < file_count_; ++i) {
+    (*output)[i] = std::string(FileName(i));
+  }
+  return true;
+}
+
+// ===================================================================
+
 DescriptorPoolDatabase::DescriptorPoolDatabase(
     const DescriptorPool& pool, DescriptorPoolDatabaseOptions options)
     : pool_(pool), options_(std::move(options)) {}
@@ -14,11 +14,13 @@
 #ifndef GOOGLE_PROTOBUF_DESCRIPTOR_DATABASE_H__
 #define GOOGLE_PROTOBUF_DESCRIPTOR_DATABASE_H__
 
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/btree_map.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/port.h"
 
@@ -32,10 +34,14 @@
 namespace google {
 namespace protobuf {
 
+// Defined in descriptor.pb.h.
+class FileDescriptorSet;
+
 // Defined in this file.
 class DescriptorDatabase;
 class SimpleDescriptorDatabase;
 class EncodedDescriptorDatabase;
+class DescriptorImageDatabase;
 class DescriptorPoolDatabase;
 class MergedDescriptorDatabase;
 
@@ -311,6 +317,75 @@ class PROTOBUF_EXPORT EncodedDescriptorDatabase : public DescriptorDatabase {
                   FileDescriptorProto* output);
 };
 
+// A read-only DescriptorDatabase backed by a precompiled image of a set of
+// files.  The image holds the encoded FileDescriptorProtos together with
+// sorted name, symbol, and extension indexes, and contains no pointers, so it
+// can be written to disk once (see BuildImage()) and later mmap()ed by any
+// number of processes.  Open() only validates the header; lookups binary
+// search the indexes in place and parse just the file being returned, so
+// startup cost does not grow with the number of files in the image.
+//
+// To get descriptors, wrap the database in a DescriptorPool, which builds
+// files lazily as they are looked up.
+//
+// The same caveats regarding FindFileContainingExtension() apply as with
+// SimpleDescriptorDatabase.
+class PROTOBUF_EXPORT DescriptorImageDatabase : public DescriptorDatabase {
+ public:
+  DescriptorImageDatabase();
+  DescriptorImageDatabase(const DescriptorImageDatabase&) = delete;
+  DescriptorImageDatabase& operator=(const DescriptorImageDatabase&) = delete;
+  ~DescriptorImageDatabase() override;
+
+  // Writes an image containing all files in `files` to `*output`.  Returns
+  // false and logs an error if the files conflict with each other in the
+  // same ways that SimpleDescriptorDatabase::Add() rejects.
+  static bool BuildImage(const FileDescriptorSet& files, std::string* output);
+
+  // Points the database at `image`, replacing any previously opened image.
+  // The database does not make a copy of the bytes, nor does it take
+  // ownership; it's up to the caller to make sure the bytes remain valid for
+  // the life of the database.  Returns false and logs an error if `image` was
+  // not produced by BuildImage().
+  bool Open(absl::string_view image);
+
+  // implements DescriptorDatabase -----------------------------------
+  bool FindFileByName(const std::string& filename,
+                      FileDescriptorProto* output) override;
+  bool FindFileContainingSymbol(const std::string& symbol_name,
+                                FileDescriptorProto* output) override;
+  bool FindFileContainingExtension(const std::string& containing_type,
+                                   int field_number,
+                                   FileDescriptorProto* output) override;
+  bool FindAllExtensionNumbers(const std::string& extendee_type,
+                               std::vector<int>* output) override;
+  bool FindAllFileNames(std::vector<std::string>* output) override;
+
+ private:
+  uint32_t Word(uint32_t offset) const;
+  absl::string_view Bytes(uint32_t offset, uint32_t size) const;
+  absl::string_view FileName(uint32_t index) const;
+  absl::string_view SymbolName(uint32_t index) const;
+  absl::string_view ExtendeeName(uint32_t index) const;
+  uint32_t ExtensionNumber(uint32_t index) const;
+
+  // Returns the index of the file containing `symbol_name`, or -1.
+  int64_t FindSymbolFile(absl::string_view symbol_name) const;
+  // Returns the first extension entry not less than (extendee, number).
+  uint32_t LowerBoundExtension(absl::string_view extendee,
+                               uint32_t number) const;
+
+  // Parses file number `index` into *output.
+  bool ParseFile(uint32_t index, FileDescriptorProto* output) const;
+
+  absl::string_view image_;
+  uint32_t file_count_ = 0;
+  uint32_t symbol_count_ = 0;
+  uint32_t extension_count_ = 0;
+  uint32_t symbols_offset_ = 0;
+  uint32_t extensions_offset_ = 0;
+};
+
 struct PROTOBUF_EXPORT DescriptorPoolDatabaseOptions {
   // If true, the database will preserve source code info when returning
   // descriptors.
@@ -15,10 +15,15 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/test_textproto.h"
 #include "google/protobuf/text_format.h"
@@ -102,6 +107,33 @@ class EncodedDescriptorDatabaseTestCase : public DescriptorDatabaseTestCase {
   EncodedDescriptorDatabase database_;
 };
 
+// Specialization for DescriptorImageDatabase.  Images are immutable, so each
+// addition rebuilds the image from every file added so far.
+class DescriptorImageDatabaseTestCase : public DescriptorDatabaseTestCase {
+ public:
+  static DescriptorDatabaseTestCase* New() {
+    return new DescriptorImageDatabaseTestCase;
+  }
+
+  virtual ~DescriptorImageDatabaseTestCase() {}
+
+  virtual DescriptorDatabase* GetDatabase() { return &database_; }
+  virtual bool AddToDatabase(const FileDescriptorProto& file) {
+    FileDescriptorSet files = files_;
+    *files.add_file() = file;
+    std::string image;
+    if (!DescriptorImageDatabase::BuildImage(files, &image)) return false;
+    files_ = std::move(files);
+    image_ = std::move(image);
+    return database_.Open(image_);
+  }
+
+ private:
+  FileDescriptorSet files_;
+  std::string image_;
+  DescriptorImageDatabase database_;
+};
+
 // Specialization for DescriptorPoolDatabase.
 class DescriptorPoolDatabaseTestCase : public DescriptorDatabaseTestCase {
  public:
@@ -453,6 +485,9 @@ INSTANTIATE_TEST_SUITE_P(
     testing::Values(&EncodedDescriptorDatabaseTestCase::New));
 INSTANTIATE_TEST_SUITE_P(Pool, DescriptorDatabaseTest,
                          testing::Values(&DescriptorPoolDatabaseTestCase::New));
+INSTANTIATE_TEST_SUITE_P(
+    Image, DescriptorDatabaseTest,
+    testing::Values(&DescriptorImageDatabaseTestCase::New));
 
 TEST(EncodedDescriptorDatabaseExtraTest, FindNameOfFileContainingSymbol) {
   // Create two files, one of which is in two parts.
@@ -488,6 +523,112 @@ TEST(EncodedDescriptorDatabaseExtraTest, FindNameOfFileContainingSymbol) {
   EXPECT_FALSE(db.FindNameOfFileContainingSymbol("baz.Baz", &filename));
 }
 
+TEST(EncodedDescriptorDatabaseExtraTest, IndexesOnlyWhatItNeeds) {
+  FileDescriptorProto file;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        name: "foo.proto"
+        package: "foo"
+        message_type {
+          name: "Foo"
+          field { name: "a" number: 1 label: LABEL_OPTIONAL type: TYPE_INT32 }
+          nested_type {
+            name: "Bar"
+            extension {
+              name: "ext"
+              number: 100
+              label: LABEL_OPTIONAL
+              type: TYPE_INT32
+              extendee: ".foo.Foo"
+            }
+          }
+          extension_range { start: 100 end: 200 }
+          options { deprecated: true }
+        }
+        enum_type {
+          name: "Baz"
+          value { name: "BAZ_UNKNOWN" number: 0 }
+        }
+        service { name: "Qux" }
+        options { java_package: "com.foo" }
+      )pb",
+      &file));
+  std::string data = file.SerializeAsString();
+
+  EncodedDescriptorDatabase db;
+  ASSERT_TRUE(db.Add(data.data(), data.size()));
+
+  for (const char* symbol :
+       {"foo.Foo", "foo.Foo.Bar.ext", "foo.Baz", "foo.Qux"}) {
+    FileDescriptorProto result;
+    EXPECT_TRUE(db.FindFileContainingSymbol(symbol, &result)) << symbol;
+    EXPECT_EQ(result.SerializeAsString(), data) << symbol;
+  }
+  FileDescriptorProto result;
+  EXPECT_TRUE(db.FindFileContainingExtension("foo.Foo", 100, &result));
+  std::vector<int> numbers;
+  EXPECT_TRUE(db.FindAllExtensionNumbers("foo.Foo", &numbers));
+  EXPECT_THAT(numbers, testing::ElementsAre(100));
+
+  // Truncated data is still rejected.
+  EncodedDescriptorDatabase truncated_db;
+  EXPECT_FALSE(truncated_db.Add(data.data(), data.size() - 1));
+}
+
+TEST(DescriptorImageDatabaseExtraTest, LazilyBuildsPool) {
+  FileDescriptorSet files;
+  ASSERT_TRUE(TextFormat::ParseFromString(
+      R"pb(
+        file { name: "foo.proto" package: "foo" message_type { name: "Foo" } }
+        file {
+          name: "bar.proto"
+          package: "bar"
+          dependency: "foo.proto"
+          message_type {
+            name: "Bar"
+            field {
+              name: "foo"
+              number: 1
+              label: LABEL_OPTIONAL
+              type: TYPE_MESSAGE
+              type_name: ".foo.Foo"
+            }
+          }
+        }
+      )pb",
+      &files));
+  std::string image;
+  ASSERT_TRUE(DescriptorImageDatabase::BuildImage(files, &image));
+
+  // Offsets are relative to the image, so it may live at any address.
+  std::string shifted = absl::StrCat("x", image);
+  DescriptorImageDatabase db;
+  ASSERT_TRUE(db.Open(absl::string_view(shifted).substr(1)));
+
+  DescriptorPool pool(&db);
+  const Descriptor* bar = pool.FindMessageTypeByName("bar.Bar");
+  ASSERT_NE(bar, nullptr);
+  EXPECT_EQ(bar->field(0)->message_type()->full_name(), "foo.Foo");
+  EXPECT_EQ(pool.FindMessageTypeByName("baz.Baz"), nullptr);
+}
+
+TEST(DescriptorImageDatabaseExtraTest, RejectsInvalidImage) {
+  DescriptorImageDatabase db;
+  EXPECT_FALSE(db.Open(""));
+  EXPECT_FALSE(db.Open("not a descriptor image"));
+
+  FileDescriptorSet files;
+  files.add_file()->set_name("foo.proto");
+  std::string image;
+  ASSERT_TRUE(DescriptorImageDatabase::BuildImage(files, &image));
+  EXPECT_FALSE(db.Open(absl::string_view(image).substr(0, 20)));
+  ASSERT_TRUE(db.Open(image));
+
+  std::vector<std::string> names;
+  EXPECT_TRUE(db.FindAllFileNames(&names));
+  EXPECT_THAT(names, testing::ElementsAre("foo.proto"));
+}
+
 TEST(SimpleDescriptorDatabaseExtraTest, FindAllFileNames) {
   FileDescriptorProto f;
   f.set_name("foo.proto");
@@ -23,6 +23,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -1000,6 +1001,12 @@ TEST_F(DescriptorTest, FieldJsonName) {
   EXPECT_EQ("FIELDNAME5", message4_->field(4)->json_name());
   EXPECT_EQ("@type", message4_->field(5)->json_name());
 
+  EXPECT_EQ(message4_->field(0), message4_->FindFieldByJsonName("fieldName1"));
+  EXPECT_EQ(message4_->field(0), message4_->FindFieldByJsonName("field_name1"));
+  EXPECT_EQ(message4_->field(5), message4_->FindFieldByJsonName("@type"));
+  EXPECT_EQ(message4_->field(5), message4_->FindFieldByJsonName("fieldName6"));
+  EXPECT_EQ(message4_->field(5), message4_->FindFieldByJsonName("field_name6"));
+
   DescriptorProto proto;
   message4_->CopyTo(&proto);
   ASSERT_EQ(7, proto.field_size());
@@ -1512,6 +1519,20 @@ TEST_F(StylizedFieldNamesTest, FindByCamelcaseName) {
   EXPECT_TRUE(file_->FindExtensionByCamelcaseName("nosuchfield") == nullptr);
 }
 
+TEST_F(StylizedFieldNamesTest, FindByJsonName) {
+  // Camel-case names take precedence over names, so fooFoo resolves to
+  // foo_foo rather than to the field named fooFoo.
+  EXPECT_EQ(message_->field(0), message_->FindFieldByJsonName("fooFoo"));
+  EXPECT_EQ(message_->field(0), message_->FindFieldByJsonName("foo_foo"));
+  EXPECT_EQ(message_->field(1), message_->FindFieldByJsonName("fooBar"));
+  EXPECT_EQ(message_->field(1), message_->FindFieldByJsonName("FooBar"));
+  EXPECT_EQ(message_->field(2), message_->FindFieldByJsonName("fooBaz"));
+  EXPECT_EQ(message_->field(4), message_->FindFieldByJsonName("foobar"));
+  EXPECT_TRUE(message_->FindFieldByJsonName("barFoo") == nullptr);
+  EXPECT_TRUE(message_->FindFieldByJsonName("bar_foo") == nullptr);
+  EXPECT_TRUE(message_->FindFieldByJsonName("nosuchfield") == nullptr);
+}
+
 // ===================================================================
 
 // Test enum descriptors.
@@ -4285,6 +4306,36 @@ TEST_F(ValidationErrorTest, UnknownDependency) {
       "loaded.\n");
 }
 
+TEST(DescriptorPoolSpaceTest, FilesSharePackageNames) {
+  DescriptorPool pool;
+  FileDescriptorProto proto;
+  proto.set_name("foo.proto");
+  proto.set_package("some.rather.long.package.name");
+  const FileDescriptor* foo = pool.BuildFile(proto);
+  ASSERT_NE(foo, nullptr);
+  const size_t space_after_foo = pool.InternalSpaceUsed();
+  EXPECT_GT(space_after_foo, 0);
+
+  proto.set_name("bar.proto");
+  const FileDescriptor* bar = pool.BuildFile(proto);
+  ASSERT_NE(bar, nullptr);
+  EXPECT_EQ(&bar->package(), &foo->package());
+  EXPECT_GT(pool.InternalSpaceUsed(), space_after_foo);
+
+  // A parent package is only a sub-package symbol, so it can't be shared.
+  proto.set_name("baz.proto");
+  proto.set_package("some.rather.long");
+  const FileDescriptor* baz = pool.BuildFile(proto);
+  ASSERT_NE(baz, nullptr);
+  EXPECT_EQ(baz->package(), "some.rather.long");
+
+  proto.set_name("qux.proto");
+  proto.clear_package();
+  const FileDescriptor* qux = pool.BuildFile(proto);
+  ASSERT_NE(qux, nullptr);
+  EXPECT_EQ(qux->package(), "");
+}
+
 TEST_F(ValidationErrorTest, InvalidPublicDependencyIndex) {
   BuildFile("name: \"foo.proto\"");
   BuildFileWithErrors(
@@ -7578,6 +7629,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   legacy_closed_enum: true
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(field), EqualsProto(R"pb(
                 field_presence: EXPLICIT
@@ -7590,6 +7642,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   legacy_closed_enum: true
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(group), EqualsProto(R"pb(
                 field_presence: EXPLICIT
@@ -7602,6 +7655,7 @@ TEST_F(FeaturesTest, Proto2Features) {
                   legacy_closed_enum: true
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
   EXPECT_TRUE(field->has_presence());
   EXPECT_FALSE(field->requires_utf8_validation());
@@ -7679,6 +7733,7 @@ TEST_F(FeaturesTest, Proto3Features) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
   EXPECT_THAT(GetCoreFeatures(field), EqualsProto(R"pb(
                 field_presence: IMPLICIT
@@ -7691,6 +7746,7 @@ TEST_F(FeaturesTest, Proto3Features) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
   EXPECT_FALSE(field->has_presence());
   EXPECT_FALSE(field->requires_utf8_validation());
@@ -7871,6 +7927,7 @@ TEST_F(FeaturesTest, Edition2023Defaults) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 }
               )pb"));
 
@@ -7954,6 +8011,7 @@ TEST_F(FeaturesTest, Edition2024Defaults) {
                   legacy_closed_enum: false
                   string_type: VIEW
                   enum_name_uses_string_view: true
+                  inline_string: false
                 }
               )pb"));
 
@@ -7987,6 +8045,7 @@ TEST_F(FeaturesBaseTest, DefaultEdition2023Defaults) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 }
               )pb"));
   EXPECT_FALSE(GetFeatures(file).HasExtension(pb::test));
@@ -8015,6 +8074,7 @@ TEST_F(FeaturesTest, ClearsOptions) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -8383,6 +8443,7 @@ TEST_F(FeaturesTest, NoOptions) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -8416,6 +8477,7 @@ TEST_F(FeaturesTest, FileFeatures) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -8497,6 +8559,7 @@ TEST_F(FeaturesTest, MessageFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -8608,6 +8671,7 @@ TEST_F(FeaturesTest, FieldFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9082,6 +9146,7 @@ TEST_F(FeaturesTest, EnumFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9197,6 +9262,7 @@ TEST_F(FeaturesTest, EnumValueFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9296,6 +9362,7 @@ TEST_F(FeaturesTest, OneofFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9404,6 +9471,7 @@ TEST_F(FeaturesTest, ExtensionRangeFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9497,6 +9565,7 @@ TEST_F(FeaturesTest, ServiceFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -9567,6 +9636,7 @@ TEST_F(FeaturesTest, MethodFeaturesDefault) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -10648,6 +10718,7 @@ TEST_F(FeaturesTest, UninterpretedOptions) {
                   legacy_closed_enum: false
                   string_type: STRING
                   enum_name_uses_string_view: false
+                  inline_string: false
                 })pb"));
 }
 
@@ -12324,6 +12395,37 @@ TEST_F(DatabaseBackedPoolTest, FindAllExtensions) {
   }
 }
 
+TEST_F(DatabaseBackedPoolTest, ConcurrentLookups) {
+  DescriptorPool pool(&database_);
+
+  // The threads race to build bar.proto from the database while others are
+  // already looking up its symbols without the pool mutex.
+  const Descriptor* foo = pool.FindMessageTypeByName("Foo");
+  ASSERT_TRUE(foo != nullptr);
+
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; ++j) {
+        const Descriptor* bar = pool.FindMessageTypeByName("Bar");
+        const FieldDescriptor* ext = pool.FindExtensionByNumber(foo, 5);
+        if (pool.FindMessageTypeByName("Foo") != foo || bar == nullptr ||
+            bar->name() != "Bar" || ext == nullptr ||
+            ext->full_name() != "foo_ext" ||
+            pool.FindMessageTypeByName("NoSuchType") != nullptr) {
+          mismatches.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(mismatches.load(), 0);
+  EXPECT_EQ(pool.FindExtensionByNumber(foo, 5),
+            pool.FindExtensionByName("foo_ext"));
+}
+
 TEST_F(DatabaseBackedPoolTest, ErrorWithoutErrorCollector) {
   ErrorDescriptorDatabase error_database;
   DescriptorPool pool(&error_database);
@@ -49,6 +49,7 @@
 #include <new>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/hash/hash.h"
@@ -561,6 +562,152 @@ inline int AlignOffset(int offset) { return AlignTo(offset, kSafeAlignment); }
 
 #define bitsizeof(T) (sizeof(T) * 8)
 
+static const uint32_t kNoHasBit = static_cast<uint32_t>(-1);
+
+// One entry of the per-type serialization plan built by GetPrototypeNoLock().
+// Singular fields stored inline in the message are serialized and sized
+// straight from their offsets.  Everything else (repeated fields, oneofs,
+// maps, cords, weak fields) is delegated to WireFormat one field at a time.
+struct SerializationStep {
+  enum Kind : uint8_t {
+    kScalar,      // Numeric, bool or enum value stored inline.
+    kString,      // string or bytes stored as an ArenaStringPtr.
+    kMessage,     // Singular message or group stored as a Message*.
+    kReflection,  // Handled by WireFormat through reflection.
+    kExtensions,  // An extension range, read from the ExtensionSet.
+  };
+
+  Kind kind;
+  uint8_t tag_size;
+  FieldDescriptor::Type type;
+  uint32_t has_bit;  // kNoHasBit for fields without a hasbit.
+  uint32_t offset;
+  int number;      // Field number, or the start of an extension range.
+  int end_number;  // Exclusive end of an extension range.
+  const FieldDescriptor* field;
+};
+
+SerializationStep MakeFieldStep(const FieldDescriptor* field, uint32_t offset,
+                                uint32_t has_bit) {
+  typedef FieldDescriptor FD;  // avoid line wrapping
+  SerializationStep step;
+  step.tag_size = static_cast<uint8_t>(
+      internal::WireFormat::TagSize(field->number(), field->type()));
+  step.type = field->type();
+  step.has_bit = has_bit;
+  step.offset = offset;
+  step.number = field->number();
+  step.end_number = field->number() + 1;
+  step.field = field;
+  if (field->is_repeated() || InRealOneof(field) || field->options().weak()) {
+    step.kind = SerializationStep::kReflection;
+  } else if (field->cpp_type() == FD::CPPTYPE_MESSAGE) {
+    step.kind = has_bit == kNoHasBit ? SerializationStep::kReflection
+                                     : SerializationStep::kMessage;
+  } else if (field->cpp_type() == FD::CPPTYPE_STRING) {
+    step.kind = field->cpp_string_type() == FD::CppStringType::kCord
+                    ? SerializationStep::kReflection
+                    : SerializationStep::kString;
+  } else {
+    step.kind = SerializationStep::kScalar;
+  }
+  return step;
+}
+
+SerializationStep MakeExtensionRangeStep(
+    const Descriptor::ExtensionRange* range) {
+  SerializationStep step;
+  step.kind = SerializationStep::kExtensions;
+  step.tag_size = 0;
+  step.type = FieldDescriptor::TYPE_MESSAGE;
+  step.has_bit = kNoHasBit;
+  step.offset = 0;
+  step.number = range->start_number();
+  step.end_number = range->end_number();
+  step.field = nullptr;
+  return step;
+}
+
+// Implicit presence for scalars matches Reflection::HasField(): the field is
+// present iff its bit pattern is nonzero (so -0.0 is serialized).
+bool ScalarIsNonZero(FieldDescriptor::Type type, const void* ptr) {
+  switch (type) {
+    case FieldDescriptor::TYPE_BOOL:
+      return *static_cast<const bool*>(ptr);
+    case FieldDescriptor::TYPE_DOUBLE:
+    case FieldDescriptor::TYPE_INT64:
+    case FieldDescriptor::TYPE_UINT64:
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_SINT64:
+      return *static_cast<const uint64_t*>(ptr) != 0;
+    default:
+      return *static_cast<const uint32_t*>(ptr) != 0;
+  }
+}
+
+uint8_t* WriteScalar(const SerializationStep& step, const void* ptr,
+                     uint8_t* target) {
+  using internal::WireFormatLite;
+  switch (step.type) {
+#define HANDLE_TYPE(TYPE, CPPTYPE, METHOD)                                   \
+  case FieldDescriptor::TYPE_##TYPE:                                         \
+    return WireFormatLite::Write##METHOD##ToArray(                           \
+        step.number, *static_cast<const CPPTYPE*>(ptr), target);
+    HANDLE_TYPE(INT32, int32_t, Int32)
+    HANDLE_TYPE(INT64, int64_t, Int64)
+    HANDLE_TYPE(SINT32, int32_t, SInt32)
+    HANDLE_TYPE(SINT64, int64_t, SInt64)
+    HANDLE_TYPE(UINT32, uint32_t, UInt32)
+    HANDLE_TYPE(UINT64, uint64_t, UInt64)
+    HANDLE_TYPE(FIXED32, uint32_t, Fixed32)
+    HANDLE_TYPE(FIXED64, uint64_t, Fixed64)
+    HANDLE_TYPE(SFIXED32, int32_t, SFixed32)
+    HANDLE_TYPE(SFIXED64, int64_t, SFixed64)
+    HANDLE_TYPE(FLOAT, float, Float)
+    HANDLE_TYPE(DOUBLE, double, Double)
+    HANDLE_TYPE(BOOL, bool, Bool)
+    HANDLE_TYPE(ENUM, int, Enum)
+#undef HANDLE_TYPE
+    default:
+      break;
+  }
+  ABSL_DLOG(FATAL) << "Can't get here.";
+  return target;
+}
+
+// Size of the value only; the caller adds the tag.
+size_t ScalarByteSize(const SerializationStep& step, const void* ptr) {
+  using internal::WireFormatLite;
+  switch (step.type) {
+#define HANDLE_TYPE(TYPE, CPPTYPE, METHOD) \
+  case FieldDescriptor::TYPE_##TYPE:       \
+    return WireFormatLite::METHOD##Size(*static_cast<const CPPTYPE*>(ptr));
+    HANDLE_TYPE(INT32, int32_t, Int32)
+    HANDLE_TYPE(INT64, int64_t, Int64)
+    HANDLE_TYPE(SINT32, int32_t, SInt32)
+    HANDLE_TYPE(SINT64, int64_t, SInt64)
+    HANDLE_TYPE(UINT32, uint32_t, UInt32)
+    HANDLE_TYPE(UINT64, uint64_t, UInt64)
+    HANDLE_TYPE(ENUM, int, Enum)
+#undef HANDLE_TYPE
+    case FieldDescriptor::TYPE_FIXED32:
+    case FieldDescriptor::TYPE_SFIXED32:
+    case FieldDescriptor::TYPE_FLOAT:
+      return WireFormatLite::kFixed32Size;
+    case FieldDescriptor::TYPE_FIXED64:
+    case FieldDescriptor::TYPE_SFIXED64:
+    case FieldDescriptor::TYPE_DOUBLE:
+      return WireFormatLite::kFixed64Size;
+    case FieldDescriptor::TYPE_BOOL:
+      return WireFormatLite::kBoolSize;
+    default:
+      break;
+  }
+  ABSL_DLOG(FATAL) << "Can't get here.";
+  return 0;
+}
+
 }  // namespace
 
 // ===================================================================
@@ -622,6 +769,15 @@ class DynamicMessage final : public Message {
   static void* NewImpl(const void* prototype, void* mem, Arena* arena);
   static void DestroyImpl(MessageLite& ptr);
 
+  // Walk TypeInfo::serialization_plan instead of going through reflection for
+  // every field.  Types without a plan fall back to the Message versions.
+  static size_t ByteSizeLongImpl(const MessageLite& msg);
+  static uint8_t* _InternalSerializeImpl(const MessageLite& msg,
+                                         uint8_t* target,
+                                         io::EpsCopyOutputStream* stream);
+
+  bool HasPlannedField(const SerializationStep& step) const;
+
   void* MutableRaw(int i);
   void* MutableExtensionsRaw();
   void* MutableWeakFieldMapRaw();
@@ -647,6 +803,12 @@ struct DynamicMessageFactory::TypeInfo {
   std::unique_ptr<uint32_t[]> has_bits_indices;
   int weak_field_map_offset;  // The offset for the weak_field_map;
 
+  // Fields and extension ranges in field number order.  Only used when
+  // use_serialization_plan is set; map entries and MessageSets have special
+  // wire formats and always go through WireFormat.
+  std::vector<SerializationStep> serialization_plan;
+  bool use_serialization_plan = false;
+
   internal::ClassDataFull class_data = {
       internal::ClassData{
           nullptr,  // default_instance
@@ -1020,6 +1182,146 @@ const internal::ClassData* DynamicMessage::GetClassData() const {
   return type_info_->class_data.base();
 }
 
+bool DynamicMessage::HasPlannedField(const SerializationStep& step) const {
+  if (step.has_bit != kNoHasBit) {
+    const uint32_t* has_bits = static_cast<const uint32_t*>(
+        OffsetToPointer(type_info_->has_bits_offset));
+    return (has_bits[step.has_bit / 32] & (1u << (step.has_bit % 32))) != 0;
+  }
+  const void* field_ptr = OffsetToPointer(step.offset);
+  if (step.kind == SerializationStep::kString) {
+    return !static_cast<const ArenaStringPtr*>(field_ptr)->Get().empty();
+  }
+  return ScalarIsNonZero(step.type, field_ptr);
+}
+
+size_t DynamicMessage::ByteSizeLongImpl(const MessageLite& base) {
+  using internal::WireFormat;
+  using internal::WireFormatLite;
+  const auto& msg = static_cast<const DynamicMessage&>(base);
+  const DynamicMessageFactory::TypeInfo* type_info = msg.type_info_;
+  if (!type_info->use_serialization_plan) {
+    return Message::ByteSizeLongImpl(base);
+  }
+
+  size_t size = 0;
+  for (const SerializationStep& step : type_info->serialization_plan) {
+    switch (step.kind) {
+      case SerializationStep::kScalar:
+        if (msg.HasPlannedField(step)) {
+          size += step.tag_size +
+                  ScalarByteSize(step, msg.OffsetToPointer(step.offset));
+        }
+        break;
+      case SerializationStep::kString:
+        if (msg.HasPlannedField(step)) {
+          size += step.tag_size +
+                  WireFormatLite::StringSize(
+                      static_cast<const ArenaStringPtr*>(
+                          msg.OffsetToPointer(step.offset))
+                          ->Get());
+        }
+        break;
+      case SerializationStep::kMessage:
+        if (msg.HasPlannedField(step)) {
+          const Message& sub = **static_cast<const Message* const*>(
+              msg.OffsetToPointer(step.offset));
+          size += step.tag_size + (step.type == FieldDescriptor::TYPE_GROUP
+                                       ? WireFormatLite::GroupSize(sub)
+                                       : WireFormatLite::MessageSize(sub));
+        }
+        break;
+      case SerializationStep::kReflection:
+        size += WireFormat::FieldByteSize(step.field, msg);
+        break;
+      case SerializationStep::kExtensions:
+        // Counted once below.
+        break;
+    }
+  }
+  if (type_info->extensions_offset != -1) {
+    size += static_cast<const ExtensionSet*>(
+                msg.OffsetToPointer(type_info->extensions_offset))
+                ->ByteSize();
+  }
+  size += WireFormat::ComputeUnknownFieldsSize(
+      msg.GetReflection()->GetUnknownFields(msg));
+
+  msg.cached_byte_size_.Set(internal::ToCachedSize(size));
+  return size;
+}
+
+uint8_t* DynamicMessage::_InternalSerializeImpl(
+    const MessageLite& base, uint8_t* target,
+    io::EpsCopyOutputStream* stream) {
+  using internal::WireFormat;
+  using internal::WireFormatLite;
+  const auto& msg = static_cast<const DynamicMessage&>(base);
+  const DynamicMessageFactory::TypeInfo* type_info = msg.type_info_;
+  if (!type_info->use_serialization_plan) {
+    return Message::_InternalSerializeImpl(base, target, stream);
+  }
+
+  for (const SerializationStep& step : type_info->serialization_plan) {
+    switch (step.kind) {
+      case SerializationStep::kScalar:
+        if (msg.HasPlannedField(step)) {
+          target = stream->EnsureSpace(target);
+          target =
+              WriteScalar(step, msg.OffsetToPointer(step.offset), target);
+        }
+        break;
+      case SerializationStep::kString:
+        if (msg.HasPlannedField(step)) {
+          const std::string& value = static_cast<const ArenaStringPtr*>(
+                                         msg.OffsetToPointer(step.offset))
+                                         ->Get();
+          if (step.type == FieldDescriptor::TYPE_STRING) {
+            if (step.field->requires_utf8_validation()) {
+              WireFormatLite::VerifyUtf8String(
+                  value.data(), value.length(), WireFormatLite::SERIALIZE,
+                  step.field->full_name());
+            } else {
+              WireFormat::VerifyUTF8StringNamedField(
+                  value.data(), value.length(), WireFormat::SERIALIZE,
+                  step.field->full_name());
+            }
+          }
+          target = stream->EnsureSpace(target);
+          target = stream->WriteString(step.number, value, target);
+        }
+        break;
+      case SerializationStep::kMessage:
+        if (msg.HasPlannedField(step)) {
+          const Message& sub = **static_cast<const Message* const*>(
+              msg.OffsetToPointer(step.offset));
+          target = stream->EnsureSpace(target);
+          if (step.type == FieldDescriptor::TYPE_GROUP) {
+            target = WireFormatLite::InternalWriteGroup(step.number, sub,
+                                                        target, stream);
+          } else {
+            target = WireFormatLite::InternalWriteMessage(
+                step.number, sub, sub.GetCachedSize(), target, stream);
+          }
+        }
+        break;
+      case SerializationStep::kReflection:
+        target = WireFormat::InternalSerializeField(step.field, msg, target,
+                                                    stream);
+        break;
+      case SerializationStep::kExtensions:
+        target = static_cast<const ExtensionSet*>(
+                     msg.OffsetToPointer(type_info->extensions_offset))
+                     ->_InternalSerialize(type_info->class_data.prototype,
+                                          step.number, step.end_number,
+                                          target, stream);
+        break;
+    }
+  }
+  return WireFormat::InternalSerializeUnknownFieldsToArray(
+      msg.GetReflection()->GetUnknownFields(msg), target, stream);
+}
+
 // ===================================================================
 
 DynamicMessageFactory::DynamicMessageFactory()
@@ -1148,6 +1450,29 @@ const Message* DynamicMessageFactory::GetPrototypeNoLock(
 
   type_info->weak_field_map_offset = -1;
 
+  // Fields that live inline in the message are serialized straight from their
+  // offsets, so work out once per type how each field is read and the order
+  // in which fields and extension ranges are written.
+  type_info->use_serialization_plan = !type->options().map_entry() &&
+                                       !type->options().message_set_wire_format();
+  if (type_info->use_serialization_plan) {
+    std::vector<SerializationStep>& plan = type_info->serialization_plan;
+    plan.reserve(type->field_count() + type->extension_range_count());
+    for (int i = 0; i < type->field_count(); i++) {
+      uint32_t has_bit = type_info->has_bits_indices != nullptr
+                             ? type_info->has_bits_indices[i]
+                             : kNoHasBit;
+      plan.push_back(MakeFieldStep(type->field(i), offsets[i], has_bit));
+    }
+    for (int i = 0; i < type->extension_range_count(); i++) {
+      plan.push_back(MakeExtensionRangeStep(type->extension_range(i)));
+    }
+    std::sort(plan.begin(), plan.end(),
+              [](const SerializationStep& a, const SerializationStep& b) {
+                return a.number < b.number;
+              });
+  }
+
   type_info->class_data.message_creator =
       internal::MessageCreator(DynamicMessage::NewImpl, size, kSafeAlignment);
 
@@ -30,6 +30,7 @@
 #include "google/protobuf/test_util.h"
 #include "google/protobuf/unittest.pb.h"
 #include "google/protobuf/unittest_no_field_presence.pb.h"
+#include "google/protobuf/wire_format.h"
 
 
 namespace google {
@@ -336,6 +337,72 @@ TEST_F(DynamicMessageTest, Proto3) {
   delete message;
 }
 
+TEST_P(DynamicMessageTest, SerializationMatchesGeneratedCode) {
+  // DynamicMessage serializes through a precomputed per-type plan; the bytes
+  // must be the same as generated code and the size the same as WireFormat.
+  Arena arena;
+  Message* message = prototype_->New(GetParam() ? &arena : nullptr);
+  TestUtil::ReflectionTester(descriptor_).SetAllFieldsViaReflection(message);
+  protobuf_unittest::TestAllTypes generated;
+  TestUtil::SetAllFields(&generated);
+  EXPECT_EQ(internal::WireFormat::ByteSize(*message), message->ByteSizeLong());
+  EXPECT_EQ(generated.SerializeAsString(), message->SerializeAsString());
+
+  Message* extensions =
+      extensions_prototype_->New(GetParam() ? &arena : nullptr);
+  TestUtil::ReflectionTester(extensions_descriptor_)
+      .SetAllFieldsViaReflection(extensions);
+  protobuf_unittest::TestAllExtensions generated_extensions;
+  TestUtil::SetAllExtensions(&generated_extensions);
+  EXPECT_EQ(internal::WireFormat::ByteSize(*extensions),
+            extensions->ByteSizeLong());
+  EXPECT_EQ(generated_extensions.SerializeAsString(),
+            extensions->SerializeAsString());
+
+  Message* oneof = oneof_prototype_->New(GetParam() ? &arena : nullptr);
+  const Reflection* oneof_refl = oneof->GetReflection();
+  oneof_refl->SetString(oneof, oneof_descriptor_->FindFieldByName("foo_string"),
+                        "foo");
+  oneof_refl->SetInt32(oneof, oneof_descriptor_->FindFieldByName("bar_int"),
+                       7);
+  EXPECT_EQ(internal::WireFormat::ByteSize(*oneof), oneof->ByteSizeLong());
+  std::string oneof_data = oneof->SerializeAsString();
+  Message* oneof_copy = oneof_prototype_->New(GetParam() ? &arena : nullptr);
+  ASSERT_TRUE(oneof_copy->ParseFromString(oneof_data));
+  EXPECT_EQ(oneof_data, oneof_copy->SerializeAsString());
+
+  if (!GetParam()) {
+    delete message;
+    delete extensions;
+    delete oneof;
+    delete oneof_copy;
+  }
+}
+
+TEST_F(DynamicMessageTest, SerializationUsesImplicitPresence) {
+  std::unique_ptr<Message> message(proto3_prototype_->New());
+  const Reflection* refl = message->GetReflection();
+  const Descriptor* desc = message->GetDescriptor();
+
+  // Zero values and empty strings are not written for implicit presence;
+  // -0.0 differs from the default by its bit pattern and is.
+  refl->SetInt32(message.get(), desc->FindFieldByName("optional_int32"), 0);
+  refl->SetString(message.get(), desc->FindFieldByName("optional_string"), "");
+  EXPECT_EQ(0, message->ByteSizeLong());
+  EXPECT_EQ("", message->SerializeAsString());
+
+  refl->SetInt32(message.get(), desc->FindFieldByName("optional_int32"), 42);
+  refl->SetFloat(message.get(), desc->FindFieldByName("optional_float"), -0.0f);
+  refl->SetString(message.get(), desc->FindFieldByName("optional_string"),
+                  "abc");
+  proto2_nofieldpresence_unittest::TestAllTypes generated;
+  generated.set_optional_int32(42);
+  generated.set_optional_float(-0.0f);
+  generated.set_optional_string("abc");
+  EXPECT_EQ(generated.ByteSizeLong(), message->ByteSizeLong());
+  EXPECT_EQ(generated.SerializeAsString(), message->SerializeAsString());
+}
+
 INSTANTIATE_TEST_SUITE_P(UseArena, DynamicMessageTest, ::testing::Bool());
 
 
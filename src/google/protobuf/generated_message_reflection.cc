@@ -2220,6 +2220,47 @@ void Reflection::SetEnumValueInternal(Message* message,
   }
 }
 
+internal::FieldAccessPlan Reflection::MakeFieldAccessPlan(
+    const FieldDescriptor* field, FieldDescriptor::CppType cpp_type) const {
+  USAGE_CHECK_MESSAGE_TYPE(MakeAccessor);
+  USAGE_CHECK_SINGULAR(MakeAccessor);
+  if (field->cpp_type() != cpp_type &&
+      !(cpp_type == FieldDescriptor::CPPTYPE_INT32 &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM)) {
+    ReportReflectionUsageTypeError(descriptor_, field, "MakeAccessor",
+                                   cpp_type);
+  }
+  USAGE_CHECK(cpp_type != FieldDescriptor::CPPTYPE_STRING ||
+                  field->cpp_string_type() !=
+                      FieldDescriptor::CppStringType::kCord,
+              MakeAccessor, "Cord fields are not supported; use GetCord().");
+
+  internal::FieldAccessPlan plan;
+  plan.reflection = this;
+  plan.field = field;
+  plan.offset = 0;
+  plan.has_bits_offset = 0;
+  plan.has_bit_index = static_cast<uint32_t>(-1);
+  // Everything the accessor cannot reach at a fixed offset from the message
+  // goes through the regular accessors.
+  plan.direct_get = !field->is_extension() && !schema_.InRealOneof(field) &&
+                    !schema_.IsSplit(field) &&
+                    !(cpp_type == FieldDescriptor::CPPTYPE_STRING &&
+                      IsInlined(field));
+  // Closed enums store out-of-range values in the unknown fields.
+  plan.direct_set = plan.direct_get &&
+                    (field->cpp_type() != FieldDescriptor::CPPTYPE_ENUM ||
+                     CreateUnknownEnumValues(field));
+  if (plan.direct_get) {
+    plan.offset = schema_.GetFieldOffsetNonOneof(field);
+    if (schema_.HasHasbits()) {
+      plan.has_bits_offset = schema_.HasBitsOffset();
+      plan.has_bit_index = schema_.HasBitIndex(field);
+    }
+  }
+  return plan;
+}
+
 const EnumValueDescriptor* Reflection::GetRepeatedEnum(
     const Message& message, const FieldDescriptor* field, int index) const {
   // Usage checked by GetRepeatedEnumValue.
@@ -261,6 +261,89 @@ TEST(GeneratedMessageReflectionTest, GetRepeatedStringViewWithExtensions) {
             reflection->GetRepeatedStringView(message, cord_ext, 0, scratch));
 }
 
+TEST(GeneratedMessageReflectionTest, MakeAccessor) {
+  unittest::TestAllTypes message;
+  const Reflection* reflection = message.GetReflection();
+  FieldAccessor<int32_t> int32_accessor =
+      reflection->MakeAccessor<int32_t>(F("optional_int32"));
+  FieldAccessor<double> double_accessor =
+      reflection->MakeAccessor<double>(F("optional_double"));
+  FieldAccessor<bool> bool_accessor =
+      reflection->MakeAccessor<bool>(F("optional_bool"));
+  FieldAccessor<std::string> string_accessor =
+      reflection->MakeAccessor<std::string>(F("optional_string"));
+  FieldAccessor<int32_t> enum_accessor =
+      reflection->MakeAccessor<int32_t>(F("optional_nested_enum"));
+
+  EXPECT_FALSE(int32_accessor.Has(message));
+  EXPECT_EQ(0, int32_accessor.Get(message));
+  EXPECT_EQ("", string_accessor.Get(message));
+  EXPECT_EQ(41, reflection->MakeAccessor<int32_t>(F("default_int32"))
+                    .Get(message));
+  EXPECT_EQ("hello", reflection->MakeAccessor<std::string>(F("default_string"))
+                         .Get(message));
+
+  int32_accessor.Set(&message, 101);
+  double_accessor.Set(&message, 1.5);
+  bool_accessor.Set(&message, true);
+  string_accessor.Set(&message, "abc");
+  enum_accessor.Set(&message, unittest::TestAllTypes::BAZ);
+
+  EXPECT_TRUE(int32_accessor.Has(message));
+  EXPECT_TRUE(string_accessor.Has(message));
+  EXPECT_EQ(101, message.optional_int32());
+  EXPECT_EQ(1.5, message.optional_double());
+  EXPECT_TRUE(message.optional_bool());
+  EXPECT_EQ("abc", message.optional_string());
+  EXPECT_EQ(unittest::TestAllTypes::BAZ, message.optional_nested_enum());
+  EXPECT_EQ(101, int32_accessor.Get(message));
+  EXPECT_EQ("abc", string_accessor.Get(message));
+  EXPECT_EQ(unittest::TestAllTypes::BAZ, enum_accessor.Get(message));
+
+  // Closed enums keep unknown values out of the field, like SetEnumValue().
+  enum_accessor.Set(&message, 12345);
+  EXPECT_EQ(unittest::TestAllTypes::BAZ, message.optional_nested_enum());
+  EXPECT_EQ(1, reflection->GetUnknownFields(message).field_count());
+}
+
+TEST(GeneratedMessageReflectionTest, MakeAccessorFallsBackToReflection) {
+  unittest::TestAllTypes message;
+  const Reflection* reflection = message.GetReflection();
+  FieldAccessor<uint32_t> oneof_uint32 =
+      reflection->MakeAccessor<uint32_t>(F("oneof_uint32"));
+  FieldAccessor<std::string> oneof_string =
+      reflection->MakeAccessor<std::string>(F("oneof_string"));
+
+  oneof_uint32.Set(&message, 7);
+  EXPECT_TRUE(message.has_oneof_uint32());
+  EXPECT_EQ(7u, oneof_uint32.Get(message));
+  oneof_string.Set(&message, "foo");
+  EXPECT_FALSE(oneof_uint32.Has(message));
+  EXPECT_EQ(0u, oneof_uint32.Get(message));
+  EXPECT_EQ("foo", message.oneof_string());
+
+  unittest::TestAllExtensions extensions;
+  const FieldDescriptor* int32_ext =
+      extensions.GetDescriptor()->file()->FindExtensionByName(
+          "optional_int32_extension");
+  FieldAccessor<int32_t> ext_accessor =
+      extensions.GetReflection()->MakeAccessor<int32_t>(int32_ext);
+  EXPECT_FALSE(ext_accessor.Has(extensions));
+  ext_accessor.Set(&extensions, 5);
+  EXPECT_TRUE(ext_accessor.Has(extensions));
+  EXPECT_EQ(5, extensions.GetExtension(unittest::optional_int32_extension));
+  EXPECT_EQ(5, ext_accessor.Get(extensions));
+
+  proto3_unittest::TestAllTypes proto3;
+  FieldAccessor<int32_t> implicit =
+      proto3.GetReflection()->MakeAccessor<int32_t>(
+          proto3.GetDescriptor()->FindFieldByName("optional_int32"));
+  EXPECT_FALSE(implicit.Has(proto3));
+  implicit.Set(&proto3, 3);
+  EXPECT_TRUE(implicit.Has(proto3));
+  EXPECT_EQ(3, proto3.optional_int32());
+}
+
 
 class GeneratedMessageReflectionSwapTest : public testing::TestWithParam<bool> {
  protected:
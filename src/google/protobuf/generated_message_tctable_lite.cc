@@ -460,6 +460,11 @@ inline PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedParseMessageAuxImpl(
   auto& field = RefAt<RepeatedPtrFieldBase>(msg, data.offset());
   const TcParseTableBase* inner_table =
       aux_is_table ? aux.table : aux.message_default()->GetTcParseTable();
+  if (!group_coding) {
+    // Size the pointer array for the whole run of sub-messages.
+    field.Reserve(field.size() +
+                  ctx->CountRepeatedLengthDelimited(ptr, expected_tag));
+  }
   do {
     ptr += sizeof(TagType);
     MessageLite* submsg = AddMessage(inner_table, field);
@@ -562,6 +567,9 @@ inline PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedFixed(
   }
   auto& field = RefAt<RepeatedField<LayoutType>>(msg, data.offset());
   const auto tag = UnalignedLoad<TagType>(ptr);
+  // Size the field for the whole run instead of growing it repeatedly.
+  field.Reserve(field.size() +
+                ctx->CountRepeatedFixed(ptr, tag, sizeof(LayoutType)));
   do {
     field.Add(UnalignedLoad<LayoutType>(ptr + sizeof(TagType)));
     ptr += sizeof(TagType) + sizeof(LayoutType);
@@ -900,6 +908,8 @@ inline PROTOBUF_ALWAYS_INLINE const char* TcParser::RepeatedVarint(
   }
   auto& field = RefAt<RepeatedField<FieldType>>(msg, data.offset());
   const auto expected_tag = UnalignedLoad<TagType>(ptr);
+  // Size the field for the whole run instead of growing it repeatedly.
+  field.Reserve(field.size() + ctx->CountRepeatedVarint(ptr, expected_tag));
   do {
     ptr += sizeof(TagType);
     FieldType tmp;
@@ -968,6 +978,10 @@ inline PROTOBUF_ALWAYS_INLINE const char* TcParser::PackedVarint(
   // pending hasbits now:
   SyncHasbits(msg, hasbits, table);
   auto* field = &RefAt<RepeatedField<FieldType>>(msg, data.offset());
+  // Reserve exactly what the payload holds when it is fully buffered.
+  if (int count = ctx->CountPackedVarints(ptr)) {
+    field->Reserve(field->size() + count);
+  }
   return ctx->ReadPackedVarint(ptr, [field](uint64_t varint) {
     FieldType val;
     if (zigzag) {
@@ -945,6 +945,106 @@ TEST(GeneratedMessageTctableLiteTest,
   EXPECT_LE(proto.vals().Capacity(), 2048);
 }
 
+// As in PackedEnumSmallRange, kNumVals is chosen such that Reserve(kNumVals)
+// results in a different capacity than adding elements one at a time.
+constexpr int kNumReservedVals = 1023;
+
+template <typename T>
+int ReservedCapacity(int size = kNumReservedVals) {
+  RepeatedField<T> field;
+  field.Reserve(size);
+  return field.Capacity();
+}
+
+template <typename T>
+int GrownCapacity(int size) {
+  RepeatedField<T> field;
+  for (int i = 0; i < size; ++i) field.Add(T{});
+  return field.Capacity();
+}
+
+TEST(GeneratedMessageTctableLiteTest, PackedVarintReservesExactly) {
+  protobuf_unittest::TestPackedTypes proto;
+  for (int i = 0; i < kNumReservedVals; i++) {
+    proto.add_packed_int32(i * 1000);
+  }
+
+  protobuf_unittest::TestPackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_EQ(new_proto.packed_int32_size(), kNumReservedVals);
+  EXPECT_LT(new_proto.packed_int32().Capacity(),
+            proto.packed_int32().Capacity());
+  EXPECT_EQ(new_proto.packed_int32().Capacity(), ReservedCapacity<int32_t>());
+}
+
+TEST(GeneratedMessageTctableLiteTest, RepeatedVarintRunReservesExactly) {
+  protobuf_unittest::TestUnpackedTypes proto;
+  for (int i = 0; i < kNumReservedVals; i++) {
+    proto.add_unpacked_int32(i * 1000);
+  }
+
+  protobuf_unittest::TestUnpackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_EQ(new_proto.unpacked_int32_size(), kNumReservedVals);
+  EXPECT_EQ(new_proto.unpacked_int32().Capacity(),
+            ReservedCapacity<int32_t>());
+}
+
+TEST(GeneratedMessageTctableLiteTest, RepeatedFixedRunReservesExactly) {
+  protobuf_unittest::TestUnpackedTypes proto;
+  for (int i = 0; i < kNumReservedVals; i++) {
+    proto.add_unpacked_fixed32(i);
+  }
+
+  protobuf_unittest::TestUnpackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_EQ(new_proto.unpacked_fixed32_size(), kNumReservedVals);
+  EXPECT_EQ(new_proto.unpacked_fixed32().Capacity(),
+            ReservedCapacity<uint32_t>());
+}
+
+// The last field of a flat buffer lies in its final kSlopBytes, which the
+// capacity hints must still count.
+TEST(GeneratedMessageTctableLiteTest, PackedVarintAtEndReservesExactly) {
+  // A 2 byte tag, a 1 byte length and 12 single byte varints.
+  constexpr int kNumVals = 12;
+  ASSERT_NE(GrownCapacity<int64_t>(kNumVals),
+            ReservedCapacity<int64_t>(kNumVals));
+  protobuf_unittest::TestPackedTypes proto;
+  for (int i = 0; i < 100; i++) {
+    proto.add_packed_int32(i * 1000);
+  }
+  for (int i = 0; i < kNumVals; i++) {
+    proto.add_packed_int64(i);
+  }
+
+  protobuf_unittest::TestPackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_EQ(new_proto.packed_int64_size(), kNumVals);
+  EXPECT_EQ(new_proto.packed_int64().Capacity(),
+            ReservedCapacity<int64_t>(kNumVals));
+}
+
+TEST(GeneratedMessageTctableLiteTest, RepeatedVarintRunAtEndReservesExactly) {
+  // 2 byte tags and single byte varints, 18 bytes in all.
+  constexpr int kNumVals = 6;
+  ASSERT_NE(GrownCapacity<int64_t>(kNumVals),
+            ReservedCapacity<int64_t>(kNumVals));
+  protobuf_unittest::TestUnpackedTypes proto;
+  for (int i = 0; i < 100; i++) {
+    proto.add_unpacked_int32(i * 1000);
+  }
+  for (int i = 0; i < kNumVals; i++) {
+    proto.add_unpacked_int64(i);
+  }
+
+  protobuf_unittest::TestUnpackedTypes new_proto;
+  ASSERT_TRUE(new_proto.ParseFromString(proto.SerializeAsString()));
+  EXPECT_EQ(new_proto.unpacked_int64_size(), kNumVals);
+  EXPECT_EQ(new_proto.unpacked_int64().Capacity(),
+            ReservedCapacity<int64_t>(kNumVals));
+}
+
 
 }  // namespace internal
 }  // namespace protobuf
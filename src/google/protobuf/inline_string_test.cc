@@ -0,0 +1,189 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2024 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "google/protobuf/arena.h"
+#include "google/protobuf/unittest_inline_string.pb.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace {
+
+using ::protobuf_unittest::TestInlineString;
+using ::testing::IsEmpty;
+using ::testing::StrEq;
+
+// Longer than any small string buffer, so that the string data is allocated.
+const char kLongValue[] = "a value that does not fit in a small string buffer";
+const char kOtherLongValue[] = "another value that is too long to be inlined";
+
+// Returns true if `value` is stored within the storage of `message`.
+bool IsInlined(const TestInlineString& message, const std::string& value) {
+  const char* begin = reinterpret_cast<const char*>(&message);
+  const char* p = reinterpret_cast<const char*>(&value);
+  return p >= begin && p < begin + sizeof(message);
+}
+
+// Runs every test with heap allocated messages and with arena allocated ones.
+class InlineStringTest : public testing::TestWithParam<bool> {
+ protected:
+  Arena* arena() { return GetParam() ? &arena_ : nullptr; }
+
+  TestInlineString* NewMessage() {
+    if (arena() != nullptr) return Arena::Create<TestInlineString>(arena());
+    heap_messages_.push_back(std::make_unique<TestInlineString>());
+    return heap_messages_.back().get();
+  }
+
+ private:
+  Arena arena_;
+  std::vector<std::unique_ptr<TestInlineString>> heap_messages_;
+};
+
+INSTANTIATE_TEST_SUITE_P(HeapOrArena, InlineStringTest, testing::Bool(),
+                         [](const testing::TestParamInfo<bool>& info) {
+                           return info.param ? "Arena" : "Heap";
+                         });
+
+TEST_P(InlineStringTest, OnlyEligibleFieldsAreInlined) {
+  TestInlineString* message = NewMessage();
+  message->set_optional_string(kLongValue);
+  message->set_optional_bytes(kLongValue);
+  message->set_string_with_default(kLongValue);
+  message->set_oneof_string(kLongValue);
+  message->set_not_inlined_string(kLongValue);
+
+  EXPECT_TRUE(IsInlined(*message, message->optional_string()));
+  EXPECT_TRUE(IsInlined(*message, message->optional_bytes()));
+  EXPECT_FALSE(IsInlined(*message, message->string_with_default()));
+  EXPECT_FALSE(IsInlined(*message, message->oneof_string()));
+  EXPECT_FALSE(IsInlined(*message, message->not_inlined_string()));
+}
+
+TEST_P(InlineStringTest, SetGetClear) {
+  TestInlineString* message = NewMessage();
+  EXPECT_FALSE(message->has_optional_string());
+  EXPECT_THAT(message->optional_string(), IsEmpty());
+
+  message->set_optional_string(kLongValue);
+  EXPECT_TRUE(message->has_optional_string());
+  EXPECT_THAT(message->optional_string(), StrEq(kLongValue));
+
+  std::string value = kOtherLongValue;
+  message->set_optional_string(std::move(value));
+  EXPECT_THAT(message->optional_string(), StrEq(kOtherLongValue));
+
+  message->mutable_optional_string()->append("!");
+  EXPECT_THAT(message->optional_string(),
+              StrEq(std::string(kOtherLongValue) + "!"));
+
+  message->set_optional_bytes(std::string("\0\1\2", 3));
+  EXPECT_THAT(message->optional_bytes(), StrEq(std::string("\0\1\2", 3)));
+
+  message->clear_optional_string();
+  EXPECT_FALSE(message->has_optional_string());
+  EXPECT_THAT(message->optional_string(), IsEmpty());
+  EXPECT_TRUE(message->has_optional_bytes());
+
+  message->Clear();
+  EXPECT_FALSE(message->has_optional_bytes());
+  EXPECT_THAT(message->optional_bytes(), IsEmpty());
+}
+
+TEST_P(InlineStringTest, ReleaseAndSetAllocated) {
+  TestInlineString* message = NewMessage();
+  message->set_optional_string(kLongValue);
+
+  std::unique_ptr<std::string> released(message->release_optional_string());
+  ASSERT_NE(released, nullptr);
+  EXPECT_THAT(*released, StrEq(kLongValue));
+  EXPECT_FALSE(message->has_optional_string());
+  EXPECT_THAT(message->optional_string(), IsEmpty());
+  EXPECT_EQ(message->release_optional_string(), nullptr);
+
+  message->set_allocated_optional_string(new std::string(kOtherLongValue));
+  EXPECT_TRUE(message->has_optional_string());
+  EXPECT_THAT(message->optional_string(), StrEq(kOtherLongValue));
+
+  message->set_allocated_optional_string(nullptr);
+  EXPECT_FALSE(message->has_optional_string());
+}
+
+TEST_P(InlineStringTest, Copy) {
+  TestInlineString* message = NewMessage();
+  message->set_optional_string(kLongValue);
+  message->set_optional_bytes(kOtherLongValue);
+  message->mutable_optional_message()->set_optional_string(kOtherLongValue);
+
+  TestInlineString* copy = NewMessage();
+  copy->CopyFrom(*message);
+  EXPECT_THAT(copy->optional_string(), StrEq(kLongValue));
+  EXPECT_THAT(copy->optional_bytes(), StrEq(kOtherLongValue));
+  EXPECT_THAT(copy->optional_message().optional_string(),
+              StrEq(kOtherLongValue));
+
+  TestInlineString heap_copy(*message);
+  EXPECT_THAT(heap_copy.optional_string(), StrEq(kLongValue));
+
+  // The copies own their strings.
+  message->Clear();
+  EXPECT_THAT(copy->optional_string(), StrEq(kLongValue));
+  EXPECT_THAT(heap_copy.optional_string(), StrEq(kLongValue));
+}
+
+TEST_P(InlineStringTest, Swap) {
+  TestInlineString* lhs = NewMessage();
+  TestInlineString* rhs = NewMessage();
+  lhs->set_optional_string(kLongValue);
+  rhs->set_optional_string(kOtherLongValue);
+  rhs->set_optional_bytes(kLongValue);
+
+  lhs->Swap(rhs);
+  EXPECT_THAT(lhs->optional_string(), StrEq(kOtherLongValue));
+  EXPECT_THAT(lhs->optional_bytes(), StrEq(kLongValue));
+  EXPECT_THAT(rhs->optional_string(), StrEq(kLongValue));
+  EXPECT_FALSE(rhs->has_optional_bytes());
+
+  // Swapping with a message on another arena, or on the heap, copies.
+  TestInlineString other;
+  other.set_optional_string(kLongValue);
+  lhs->Swap(&other);
+  EXPECT_THAT(lhs->optional_string(), StrEq(kLongValue));
+  EXPECT_FALSE(lhs->has_optional_bytes());
+  EXPECT_THAT(other.optional_string(), StrEq(kOtherLongValue));
+  EXPECT_THAT(other.optional_bytes(), StrEq(kLongValue));
+}
+
+TEST_P(InlineStringTest, ParseAndSerialize) {
+  TestInlineString* message = NewMessage();
+  message->set_optional_string(kLongValue);
+  message->set_optional_bytes(std::string("\0\1\2", 3));
+  message->mutable_optional_message()->set_optional_string(kOtherLongValue);
+
+  TestInlineString* parsed = NewMessage();
+  ASSERT_TRUE(parsed->ParseFromString(message->SerializeAsString()));
+  EXPECT_THAT(parsed->optional_string(), StrEq(kLongValue));
+  EXPECT_THAT(parsed->optional_bytes(), StrEq(std::string("\0\1\2", 3)));
+  EXPECT_THAT(parsed->optional_message().optional_string(),
+              StrEq(kOtherLongValue));
+  EXPECT_TRUE(IsInlined(*parsed, parsed->optional_string()));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -83,6 +83,15 @@ namespace internal {
 // SetAllocated, Rvalue Set, and Swap with a non-donated string.
 //
 // For more details of the donating states transitions, go/pd-inlined-string.
+//
+// Donation relies on taking over arena allocated string buffers, which needs
+// knowledge of the std::string layout and is only enabled when
+// GOOGLE_PROTOBUF_INTERNAL_DONATE_STEAL_INLINE is defined. Otherwise,
+// `InitDonatingStates()` marks every field as undonated from construction:
+// string data always lives on the heap, every operation (including Mutable,
+// Release and Swap) acts on the std::string directly, and the owning message
+// registers its arena destructor when it is created so that the buffers are
+// freed with the arena.
 class PROTOBUF_EXPORT InlinedStringField {
  public:
   InlinedStringField() : str_() {}
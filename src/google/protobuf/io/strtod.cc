@@ -10,8 +10,8 @@
 #include <float.h>  // FLT_DIG and DBL_DIG
 
 #include <cmath>
-#include <cstdio>
-#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <string>
@@ -19,8 +19,6 @@
 
 #include "absl/log/absl_check.h"
 #include "absl/strings/charconv.h"
-#include "absl/strings/numbers.h"
-#include "absl/strings/str_format.h"
 
 namespace google {
 namespace protobuf {
@@ -89,170 +87,554 @@ double NoLocaleStrtod(const char *str, char **endptr) {
 //    It turns out there is no precision value that does the right thing
 //    for all numbers.
 //
-//    Our strategy is to first try printing with a precision that is never
-//    over-precise, then parse the result with strtod() to see if it
-//    matches.  If not, we print again with a precision that will always
-//    give a precise result, but may use more digits than necessary.
+//    We generate the digits with the Grisu3 algorithm described in "Printing
+//    Floating-Point Numbers Quickly and Accurately with Integers" by Florian
+//    Loitsch.  It only needs 64-bit integer arithmetic and a small table of
+//    powers of ten, and produces the shortest digits that parse back to the
+//    exact same value, choosing the closest ones if there are several.  For
+//    about 0.5% of inputs it cannot prove that its digits are the shortest
+//    and gives up.  We then fall back to Grisu2, which always produces digits
+//    that round-trip but not always the shortest ones, and try whether
+//    fewer digits, rounded up or down, still round-trip.
 //
-//    An arguably better strategy would be to use the algorithm described
-//    in "How to Print Floating-Point Numbers Accurately" by Steele &
-//    White, e.g. as implemented by David M. Gay's dtoa().  It turns out,
-//    however, that the following implementation is about as fast as
-//    DMG's code.  Furthermore, DMG's code locks mutexes, which means it
-//    will not scale well on multi-core machines.  DMG's code is slightly
-//    more accurate (in that it will never use more digits than
-//    necessary), but this is probably irrelevant for most users.
-//
-//    Rob Pike and Ken Thompson also have an implementation of dtoa() in
-//    third_party/fmt/fltfmt.cc.  Their implementation is similar to this
-//    one in that it makes guesses and then uses strtod() to check them.
-//    Their implementation is faster because they use their own code to
-//    generate the digits in the first place rather than use snprintf(),
-//    thus avoiding format string parsing overhead.  However, this makes
-//    it considerably more complicated than the following implementation,
-//    and it is embedded in a larger library.  If speed turns out to be
-//    an issue, we could re-implement this in terms of their
-//    implementation.
+//    We used to print with snprintf("%.15g"), parse the result with strtod()
+//    to check whether it round-trips and, if not, print again with
+//    "%.17g".  The digits are laid out the same way so that the output does
+//    not change for normal values that round-trip with 15 digits (6 for
+//    floats).
 // ----------------------------------------------------------------------
 
 namespace {
-// In practice, doubles should never need more than 24 bytes and floats
-// should never need more than 14 (including null terminators), but we
-// overestimate to be safe.
-constexpr int kDoubleToBufferSize = 32;
-constexpr int kFloatToBufferSize = 24;
-
-inline bool IsValidFloatChar(char c) {
-  return ('0' <= c && c <= '9') || c == 'e' || c == 'E' || c == '+' || c == '-';
+
+// A floating point number f * 2^e, with a 64-bit significand.
+struct DiyFp {
+  uint64_t f;
+  int e;
+};
+
+// Returns x * y, rounded to 64 bits of significand.
+DiyFp Multiply(DiyFp x, DiyFp y) {
+  const uint64_t x_lo = x.f & 0xFFFFFFFF;
+  const uint64_t x_hi = x.f >> 32;
+  const uint64_t y_lo = y.f & 0xFFFFFFFF;
+  const uint64_t y_hi = y.f >> 32;
+
+  const uint64_t lo_lo = x_lo * y_lo;
+  const uint64_t hi_lo = x_hi * y_lo;
+  const uint64_t lo_hi = x_lo * y_hi;
+  const uint64_t hi_hi = x_hi * y_hi;
+
+  uint64_t mid = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + (lo_hi & 0xFFFFFFFF);
+  mid += uint64_t{1} << 31;  // Round the lower 64 bits of the product.
+  return {hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (mid >> 32), x.e + y.e + 64};
+}
+
+DiyFp Normalize(DiyFp x) {
+  while ((x.f >> 63) == 0) {
+    x.f <<= 1;
+    --x.e;
+  }
+  return x;
 }
 
-void DelocalizeRadix(char *buffer) {
-  // Fast check:  if the buffer has a normal decimal point, assume no
-  // translation is needed.
-  if (strchr(buffer, '.') != nullptr) return;
+// The value to print and the boundaries of the interval of real numbers that
+// round to it, normalized to the same exponent.
+struct Boundaries {
+  DiyFp w;
+  DiyFp minus;
+  DiyFp plus;
+};
+
+template <typename Float, typename Bits>
+Boundaries ComputeBoundaries(Float value) {
+  static_assert(sizeof(Float) == sizeof(Bits), "");
+  constexpr int kPrecision = std::numeric_limits<Float>::digits;
+  constexpr int kBias = std::numeric_limits<Float>::max_exponent - 1 +
+                        (kPrecision - 1);
+  constexpr int kMinExp = 1 - kBias;
+  constexpr uint64_t kHiddenBit = uint64_t{1} << (kPrecision - 1);
+
+  Bits bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const uint64_t fraction = bits & (kHiddenBit - 1);
+  const int exponent =
+      static_cast<int>((bits >> (kPrecision - 1)) &
+                       ((Bits{1} << (sizeof(Bits) * 8 - kPrecision)) - 1));
+
+  const DiyFp v = exponent == 0
+                      ? DiyFp{fraction, kMinExp}
+                      : DiyFp{fraction + kHiddenBit, exponent - kBias};
+
+  // The boundaries lie halfway to the neighboring values. The lower neighbor
+  // is closer when the significand is a power of two, except for the
+  // smallest normal exponent.
+  const bool lower_is_closer = fraction == 0 && exponent > 1;
+  const DiyFp plus = Normalize({2 * v.f + 1, v.e - 1});
+  DiyFp minus = lower_is_closer ? DiyFp{4 * v.f - 1, v.e - 2}
+                                : DiyFp{2 * v.f - 1, v.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+  return {Normalize(v), minus, plus};
+}
+
+// Normalized powers of ten 10^k, with k from kCachedPowersMinExp in steps of
+// kCachedPowersStep. They cover the exponents of all finite doubles.
+struct CachedPower {
+  uint64_t f;
+  int e;
+  int k;
+};
+
+constexpr int kCachedPowersMinExp = -300;
+constexpr int kCachedPowersStep = 8;
+constexpr CachedPower kCachedPowers[] = {
+    {0xAB70FE17C79AC6CA, -1060, -300},
+    {0xFF77B1FCBEBCDC4F, -1034, -292},
+    {0xBE5691EF416BD60C, -1007, -284},
+    {0x8DD01FAD907FFC3C, -980, -276},
+    {0xD3515C2831559A83, -954, -268},
+    {0x9D71AC8FADA6C9B5, -927, -260},
+    {0xEA9C227723EE8BCB, -901, -252},
+    {0xAECC49914078536D, -874, -244},
+    {0x823C12795DB6CE57, -847, -236},
+    {0xC21094364DFB5637, -821, -228},
+    {0x9096EA6F3848984F, -794, -220},
+    {0xD77485CB25823AC7, -768, -212},
+    {0xA086CFCD97BF97F4, -741, -204},
+    {0xEF340A98172AACE5, -715, -196},
+    {0xB23867FB2A35B28E, -688, -188},
+    {0x84C8D4DFD2C63F3B, -661, -180},
+    {0xC5DD44271AD3CDBA, -635, -172},
+    {0x936B9FCEBB25C996, -608, -164},
+    {0xDBAC6C247D62A584, -582, -156},
+    {0xA3AB66580D5FDAF6, -555, -148},
+    {0xF3E2F893DEC3F126, -529, -140},
+    {0xB5B5ADA8AAFF80B8, -502, -132},
+    {0x87625F056C7C4A8B, -475, -124},
+    {0xC9BCFF6034C13053, -449, -116},
+    {0x964E858C91BA2655, -422, -108},
+    {0xDFF9772470297EBD, -396, -100},
+    {0xA6DFBD9FB8E5B88F, -369, -92},
+    {0xF8A95FCF88747D94, -343, -84},
+    {0xB94470938FA89BCF, -316, -76},
+    {0x8A08F0F8BF0F156B, -289, -68},
+    {0xCDB02555653131B6, -263, -60},
+    {0x993FE2C6D07B7FAC, -236, -52},
+    {0xE45C10C42A2B3B06, -210, -44},
+    {0xAA242499697392D3, -183, -36},
+    {0xFD87B5F28300CA0E, -157, -28},
+    {0xBCE5086492111AEB, -130, -20},
+    {0x8CBCCC096F5088CC, -103, -12},
+    {0xD1B71758E219652C, -77, -4},
+    {0x9C40000000000000, -50, 4},
+    {0xE8D4A51000000000, -24, 12},
+    {0xAD78EBC5AC620000, 3, 20},
+    {0x813F3978F8940984, 30, 28},
+    {0xC097CE7BC90715B3, 56, 36},
+    {0x8F7E32CE7BEA5C70, 83, 44},
+    {0xD5D238A4ABE98068, 109, 52},
+    {0x9F4F2726179A2245, 136, 60},
+    {0xED63A231D4C4FB27, 162, 68},
+    {0xB0DE65388CC8ADA8, 189, 76},
+    {0x83C7088E1AAB65DB, 216, 84},
+    {0xC45D1DF942711D9A, 242, 92},
+    {0x924D692CA61BE758, 269, 100},
+    {0xDA01EE641A708DEA, 295, 108},
+    {0xA26DA3999AEF774A, 322, 116},
+    {0xF209787BB47D6B85, 348, 124},
+    {0xB454E4A179DD1877, 375, 132},
+    {0x865B86925B9BC5C2, 402, 140},
+    {0xC83553C5C8965D3D, 428, 148},
+    {0x952AB45CFA97A0B3, 455, 156},
+    {0xDE469FBD99A05FE3, 481, 164},
+    {0xA59BC234DB398C25, 508, 172},
+    {0xF6C69A72A3989F5C, 534, 180},
+    {0xB7DCBF5354E9BECE, 561, 188},
+    {0x88FCF317F22241E2, 588, 196},
+    {0xCC20CE9BD35C78A5, 614, 204},
+    {0x98165AF37B2153DF, 641, 212},
+    {0xE2A0B5DC971F303A, 667, 220},
+    {0xA8D9D1535CE3B396, 694, 228},
+    {0xFB9B7CD9A4A7443C, 720, 236},
+    {0xBB764C4CA7A44410, 747, 244},
+    {0x8BAB8EEFB6409C1A, 774, 252},
+    {0xD01FEF10A657842C, 800, 260},
+    {0x9B10A4E5E9913129, 827, 268},
+    {0xE7109BFBA19C0C9D, 853, 276},
+    {0xAC2820D9623BF429, 880, 284},
+    {0x80444B5E7AA7CF85, 907, 292},
+    {0xBF21E44003ACDD2D, 933, 300},
+    {0x8E679C2F5E44FF8F, 960, 308},
+    {0xD433179D9C8CB841, 986, 316},
+    {0x9E19DB92B4E31BA9, 1013, 324},
+};
+
+// The range of binary exponents of the scaled boundaries that DigitGen()
+// works with.
+constexpr int kAlpha = -60;
+constexpr int kGamma = -32;
+
+// Returns a cached power c = 10^k such that the binary exponent of w * c
+// lies in [kAlpha, kGamma], for a normalized w with binary exponent `e`.
+const CachedPower& GetCachedPower(int e) {
+  // 78913 / 2^18 approximates log10(2).
+  const int f = kAlpha - e - 1;
+  const int k = (f * 78913) / (1 << 18) + (f > 0);
+  const int index =
+      (-kCachedPowersMinExp + k + (kCachedPowersStep - 1)) / kCachedPowersStep;
+  ABSL_DCHECK_GE(index, 0);
+  ABSL_DCHECK_LT(index, static_cast<int>(sizeof(kCachedPowers) /
+                                         sizeof(kCachedPowers[0])));
+  const CachedPower& cached = kCachedPowers[index];
+  ABSL_DCHECK_GE(e + cached.e + 64, kAlpha);
+  ABSL_DCHECK_LE(e + cached.e + 64, kGamma);
+  return cached;
+}
+
+// Returns the number of decimal digits of `n`, and 10 to that number minus
+// one in `pow10`.
+int CountDigits(uint32_t n, uint32_t* pow10) {
+  int digits = 1;
+  *pow10 = 1;
+  while (n / *pow10 >= 10) {
+    *pow10 *= 10;
+    ++digits;
+  }
+  return digits;
+}
 
-  // Find the first unknown character.
-  while (IsValidFloatChar(*buffer)) ++buffer;
+// Moves the last digit in `buffer` towards `dist`, the distance from the upper
+// boundary to the value being printed, while staying within the rounding
+// interval `delta`. `rest` is the distance from the upper boundary to the
+// digits generated so far, and `ten_k` the value of one unit in the last
+// digit.
+void RoundWeed(char* buffer, int length, uint64_t dist, uint64_t delta,
+               uint64_t rest, uint64_t ten_k) {
+  while (rest < dist && delta - rest >= ten_k &&
+         (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+    --buffer[length - 1];
+    rest += ten_k;
+  }
+}
 
-  if (*buffer == '\0') {
-    // No radix character found.
-    return;
+// Generates the digits of `w`, which lies strictly between `minus` and `plus`,
+// into `buffer`. On return, the digits times 10^`decimal_exponent` lie within
+// the interval.
+int DigitGen(char* buffer, int* decimal_exponent, DiyFp minus, DiyFp w,
+             DiyFp plus) {
+  uint64_t delta = plus.f - minus.f;
+  uint64_t dist = plus.f - w.f;
+
+  const int shift = -plus.e;
+  const uint64_t one = uint64_t{1} << shift;
+  uint32_t integral = static_cast<uint32_t>(plus.f >> shift);
+  uint64_t fractional = plus.f & (one - 1);
+
+  int length = 0;
+  uint32_t pow10;
+  int n = CountDigits(integral, &pow10);
+  while (n > 0) {
+    buffer[length++] = static_cast<char>('0' + integral / pow10);
+    integral %= pow10;
+    --n;
+    const uint64_t rest = (uint64_t{integral} << shift) + fractional;
+    if (rest <= delta) {
+      *decimal_exponent += n;
+      RoundWeed(buffer, length, dist, delta, rest, uint64_t{pow10} << shift);
+      return length;
+    }
+    pow10 /= 10;
   }
 
-  // We are now pointing at the locale-specific radix character.  Replace it
-  // with '.'.
-  *buffer = '.';
-  ++buffer;
-
-  if (!IsValidFloatChar(*buffer) && *buffer != '\0') {
-    // It appears the radix was a multi-byte character.  We need to remove the
-    // extra bytes.
-    char *target = buffer;
-    do {
-      ++buffer;
-    } while (!IsValidFloatChar(*buffer) && *buffer != '\0');
-    memmove(target, buffer, strlen(buffer) + 1);
+  int m = 0;
+  while (true) {
+    fractional *= 10;
+    buffer[length++] = static_cast<char>('0' + (fractional >> shift));
+    fractional &= one - 1;
+    ++m;
+    delta *= 10;
+    dist *= 10;
+    if (fractional <= delta) break;
   }
+  *decimal_exponent -= m;
+  RoundWeed(buffer, length, dist, delta, fractional, one);
+  return length;
 }
 
-bool safe_strtof(const char *str, float *value) {
-  char *endptr;
-  errno = 0;  // errno only gets set on errors
-  *value = strtof(str, &endptr);
-  return *str != 0 && *endptr == 0 && errno == 0;
+// Writes the digits of the finite, positive `value` into `buffer` and returns
+// their number. The digits times 10^`decimal_exponent` parse back to `value`.
+template <typename Float, typename Bits>
+int Grisu2(Float value, char* buffer, int* decimal_exponent) {
+  const Boundaries b = ComputeBoundaries<Float, Bits>(value);
+  const CachedPower& cached = GetCachedPower(b.plus.e);
+  const DiyFp c = {cached.f, cached.e};
+
+  const DiyFp w = Multiply(b.w, c);
+  DiyFp minus = Multiply(b.minus, c);
+  DiyFp plus = Multiply(b.plus, c);
+  // The products may be off by one unit either way, so shrink the interval to
+  // make sure that it stays within the exact one.
+  ++minus.f;
+  --plus.f;
+
+  *decimal_exponent = -cached.k;
+  return DigitGen(buffer, decimal_exponent, minus, w, plus);
 }
 
-char *FloatToBuffer(float value, char *buffer) {
-  // FLT_DIG is 6 for IEEE-754 floats, which are used on almost all
-  // platforms these days.  Just in case some system exists where FLT_DIG
-  // is significantly larger -- and risks overflowing our buffer -- we have
-  // this assert.
-  static_assert(FLT_DIG < 10, "FLT_DIG_is_too_big");
-
-  if (value == std::numeric_limits<double>::infinity()) {
-    absl::SNPrintF(buffer, kFloatToBufferSize, "inf");
-    return buffer;
-  } else if (value == -std::numeric_limits<double>::infinity()) {
-    absl::SNPrintF(buffer, kFloatToBufferSize, "-inf");
-    return buffer;
-  } else if (std::isnan(value)) {
-    absl::SNPrintF(buffer, kFloatToBufferSize, "nan");
-    return buffer;
+// Like RoundWeed(), but accounts for the error of up to `unit` in `dist`,
+// `delta` and `rest`. Returns false if that error makes it impossible to tell
+// whether the digits are the closest ones within the interval.
+bool RoundWeedChecked(char* buffer, int length, uint64_t dist, uint64_t delta,
+                      uint64_t rest, uint64_t ten_k, uint64_t unit) {
+  const uint64_t small_dist = dist - unit;
+  const uint64_t big_dist = dist + unit;
+  while (rest < small_dist && delta - rest >= ten_k &&
+         (rest + ten_k < small_dist ||
+          small_dist - rest >= rest + ten_k - small_dist)) {
+    --buffer[length - 1];
+    rest += ten_k;
+  }
+  if (rest < big_dist && delta - rest >= ten_k &&
+      (rest + ten_k < big_dist || big_dist - rest > rest + ten_k - big_dist)) {
+    return false;
   }
+  // The digits must also lie safely within the interval.
+  return 2 * unit <= rest && rest <= delta - 4 * unit;
+}
 
-  int snprintf_result =
-      absl::SNPrintF(buffer, kFloatToBufferSize, "%.*g", FLT_DIG, value);
+// Like DigitGen(), but generates the shortest digits within the interval
+// between `minus` and `plus`, which are only known up to an error of one unit.
+// Returns false if the error makes it impossible to tell whether the digits
+// are the shortest and closest ones.
+bool ShortestDigitGen(char* buffer, int* length, int* decimal_exponent,
+                      DiyFp minus, DiyFp w, DiyFp plus) {
+  uint64_t unit = 1;
+  const uint64_t too_high = plus.f + unit;
+  uint64_t unsafe_interval = too_high - (minus.f - unit);
+
+  const int shift = -w.e;
+  const uint64_t one = uint64_t{1} << shift;
+  uint32_t integral = static_cast<uint32_t>(too_high >> shift);
+  uint64_t fractional = too_high & (one - 1);
+
+  *length = 0;
+  uint32_t pow10;
+  int n = CountDigits(integral, &pow10);
+  while (n > 0) {
+    buffer[(*length)++] = static_cast<char>('0' + integral / pow10);
+    integral %= pow10;
+    --n;
+    const uint64_t rest = (uint64_t{integral} << shift) + fractional;
+    if (rest < unsafe_interval) {
+      *decimal_exponent += n;
+      return RoundWeedChecked(buffer, *length, too_high - w.f,
+                              unsafe_interval, rest, uint64_t{pow10} << shift,
+                              unit);
+    }
+    pow10 /= 10;
+  }
+
+  int m = 0;
+  while (true) {
+    fractional *= 10;
+    unit *= 10;
+    unsafe_interval *= 10;
+    buffer[(*length)++] = static_cast<char>('0' + (fractional >> shift));
+    fractional &= one - 1;
+    ++m;
+    if (fractional < unsafe_interval) {
+      *decimal_exponent -= m;
+      return RoundWeedChecked(buffer, *length, (too_high - w.f) * unit,
+                              unsafe_interval, fractional, one, unit);
+    }
+  }
+}
 
-  // The snprintf should never overflow because the buffer is significantly
-  // larger than the precision we asked for.
-  ABSL_DCHECK(snprintf_result > 0 && snprintf_result < kFloatToBufferSize);
+// Like Grisu2(), but produces the shortest digits or returns false.
+template <typename Float, typename Bits>
+bool Grisu3(Float value, char* buffer, int* length, int* decimal_exponent) {
+  const Boundaries b = ComputeBoundaries<Float, Bits>(value);
+  const CachedPower& cached = GetCachedPower(b.plus.e);
+  const DiyFp c = {cached.f, cached.e};
+
+  *decimal_exponent = -cached.k;
+  return ShortestDigitGen(buffer, length, decimal_exponent,
+                          Multiply(b.minus, c), Multiply(b.w, c),
+                          Multiply(b.plus, c));
+}
 
-  float parsed_value;
-  if (!safe_strtof(buffer, &parsed_value) || parsed_value != value) {
-    snprintf_result =
-        absl::SNPrintF(buffer, kFloatToBufferSize, "%.*g", FLT_DIG + 3, value);
+// Lays out `length` digits times 10^`decimal_exponent` the way
+// printf("%.*g", precision) does, where `precision` is at least `length`.
+char* FormatDigits(char* out, const char* digits, int length,
+                   int decimal_exponent, int precision) {
+  const int exponent = length + decimal_exponent - 1;
+  if (exponent < -4 || exponent >= precision) {
+    *out++ = digits[0];
+    if (length > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, length - 1);
+      out += length - 1;
+    }
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    int abs_exponent = exponent < 0 ? -exponent : exponent;
+    if (abs_exponent >= 100) {
+      *out++ = static_cast<char>('0' + abs_exponent / 100);
+      abs_exponent %= 100;
+    }
+    *out++ = static_cast<char>('0' + abs_exponent / 10);
+    *out++ = static_cast<char>('0' + abs_exponent % 10);
+  } else if (exponent < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    memset(out, '0', -exponent - 1);
+    out += -exponent - 1;
+    memcpy(out, digits, length);
+    out += length;
+  } else if (exponent + 1 >= length) {
+    memcpy(out, digits, length);
+    out += length;
+    memset(out, '0', exponent + 1 - length);
+    out += exponent + 1 - length;
+  } else {
+    memcpy(out, digits, exponent + 1);
+    out += exponent + 1;
+    *out++ = '.';
+    memcpy(out, digits + exponent + 1, length - exponent - 1);
+    out += length - exponent - 1;
+  }
+  *out = '\0';
+  return out;
+}
 
-    // Should never overflow; see above.
-    ABSL_DCHECK(snprintf_result > 0 && snprintf_result < kFloatToBufferSize);
+// Shortens the `length` digits in `digits` to `precision` digits, rounding the
+// last one up if `round_up` is set and truncating otherwise, adjusting
+// `decimal_exponent`. Returns the new length without trailing zeros.
+int RoundDigits(char* digits, int length, int precision, bool round_up,
+                int* decimal_exponent) {
+  *decimal_exponent += length - precision;
+  length = precision;
+  if (round_up) {
+    int i = length - 1;
+    while (i >= 0 && digits[i] == '9') {
+      digits[i--] = '0';
+    }
+    if (i < 0) {
+      // All the digits were nines: the result is 10^precision.
+      digits[0] = '1';
+      *decimal_exponent += length;
+      length = 1;
+    } else {
+      ++digits[i];
+    }
   }
+  while (length > 1 && digits[length - 1] == '0') {
+    --length;
+    ++*decimal_exponent;
+  }
+  return length;
+}
 
-  DelocalizeRadix(buffer);
-  return buffer;
+// Formats `digits` into `buffer` if they parse back to `value`, and returns
+// the end of the output or nullptr.
+template <typename Float>
+char* FormatIfRoundTrips(Float value, char* buffer, const char* digits,
+                         int length, int decimal_exponent, int short_precision,
+                         int long_precision) {
+  char candidate[kDoubleToBufferSize];
+  char* end = FormatDigits(
+      candidate, digits, length, decimal_exponent,
+      length <= short_precision ? short_precision : long_precision);
+  Float parsed;
+  auto result = absl::from_chars(candidate, end, parsed);
+  if (result.ec != std::errc() || parsed != value) return nullptr;
+  memcpy(buffer, candidate, end - candidate + 1);
+  return buffer + (end - candidate);
 }
 
-char *DoubleToBuffer(double value, char *buffer) {
-  // DBL_DIG is 15 for IEEE-754 doubles, which are used on almost all
-  // platforms these days.  Just in case some system exists where DBL_DIG
-  // is significantly larger -- and risks overflowing our buffer -- we have
-  // this assert.
-  static_assert(DBL_DIG < 20, "DBL_DIG_is_too_big");
-
-  if (value == std::numeric_limits<double>::infinity()) {
-    absl::SNPrintF(buffer, kDoubleToBufferSize, "inf");
-    return buffer;
-  } else if (value == -std::numeric_limits<double>::infinity()) {
-    absl::SNPrintF(buffer, kDoubleToBufferSize, "-inf");
-    return buffer;
+// `short_precision` is the precision with which every value with that many
+// significant digits round-trips, and `long_precision` the one with which
+// every value does; they select between fixed and exponent notation.
+template <typename Float, typename Bits>
+size_t FloatingToBuffer(Float value, char* buffer, int short_precision,
+                        int long_precision) {
+  char* out = buffer;
+  if (value == std::numeric_limits<Float>::infinity()) {
+    memcpy(out, "inf", 4);
+    return 3;
+  } else if (value == -std::numeric_limits<Float>::infinity()) {
+    memcpy(out, "-inf", 5);
+    return 4;
   } else if (std::isnan(value)) {
-    absl::SNPrintF(buffer, kDoubleToBufferSize, "nan");
-    return buffer;
+    memcpy(out, "nan", 4);
+    return 3;
   }
 
-  int snprintf_result =
-      absl::SNPrintF(buffer, kDoubleToBufferSize, "%.*g", DBL_DIG, value);
-
-  // The snprintf should never overflow because the buffer is significantly
-  // larger than the precision we asked for.
-  ABSL_DCHECK(snprintf_result > 0 && snprintf_result < kDoubleToBufferSize);
-
-  // We need to make parsed_value volatile in order to force the compiler to
-  // write it out to the stack.  Otherwise, it may keep the value in a
-  // register, and if it does that, it may keep it as a long double instead
-  // of a double.  This long double may have extra bits that make it compare
-  // unequal to "value" even though it would be exactly equal if it were
-  // truncated to a double.
-  volatile double parsed_value = NoLocaleStrtod(buffer, nullptr);
-  if (parsed_value != value) {
-    snprintf_result =
-        absl::SNPrintF(buffer, kDoubleToBufferSize, "%.*g", DBL_DIG + 2, value);
-
-    // Should never overflow; see above.
-    ABSL_DCHECK(snprintf_result > 0 && snprintf_result < kDoubleToBufferSize);
+  if (std::signbit(value)) {
+    *out++ = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    *out++ = '0';
+    *out = '\0';
+    return out - buffer;
+  }
+
+  char digits[32];
+  int length;
+  int decimal_exponent;
+  if (!Grisu3<Float, Bits>(value, digits, &length, &decimal_exponent)) {
+    length = Grisu2<Float, Bits>(value, digits, &decimal_exponent);
+    while (length > 1 && digits[length - 1] == '0') {
+      --length;
+      ++decimal_exponent;
+    }
+
+    // The digits may be longer than necessary. Fewer digits that round-trip
+    // are one of the two neighbours of the digits at that precision, as they
+    // are close to the exact value; the closer one is tried first.
+    for (int precision = short_precision; precision < length; ++precision) {
+      const bool round_up = digits[precision] >= '5';
+      for (bool up : {round_up, !round_up}) {
+        char rounded[32];
+        memcpy(rounded, digits, length);
+        int rounded_exponent = decimal_exponent;
+        int rounded_length =
+            RoundDigits(rounded, length, precision, up, &rounded_exponent);
+        char* end = FormatIfRoundTrips(value, out, rounded, rounded_length,
+                                       rounded_exponent, short_precision,
+                                       long_precision);
+        if (end != nullptr) return end - buffer;
+      }
+    }
   }
 
-  DelocalizeRadix(buffer);
-  return buffer;
+  out = FormatDigits(
+      out, digits, length, decimal_exponent,
+      length <= short_precision ? short_precision : long_precision);
+  return out - buffer;
 }
+
 }  // namespace
 
+size_t DoubleToBuffer(double value, char* buffer) {
+  return FloatingToBuffer<double, uint64_t>(value, buffer, DBL_DIG,
+                                            DBL_DIG + 2);
+}
+
+size_t FloatToBuffer(float value, char* buffer) {
+  return FloatingToBuffer<float, uint32_t>(value, buffer, FLT_DIG,
+                                           FLT_DIG + 3);
+}
+
 std::string SimpleDtoa(double value) {
   char buffer[kDoubleToBufferSize];
-  return DoubleToBuffer(value, buffer);
+  return std::string(buffer, DoubleToBuffer(value, buffer));
 }
 
 std::string SimpleFtoa(float value) {
   char buffer[kFloatToBufferSize];
-  return FloatToBuffer(value, buffer);
+  return std::string(buffer, FloatToBuffer(value, buffer));
 }
 
 }  // namespace io
@@ -12,6 +12,7 @@
 #ifndef GOOGLE_PROTOBUF_IO_STRTOD_H__
 #define GOOGLE_PROTOBUF_IO_STRTOD_H__
 
+#include <cstddef>
 #include <string>
 
 // Must be included last.
@@ -27,14 +28,24 @@ namespace io {
 //    Description: converts a double or float to a string which, if
 //    passed to NoLocaleStrtod(), will produce the exact same original double
 //    (except in case of NaN; all NaNs are considered the same value).
-//    We try to keep the string short but it's not guaranteed to be as
-//    short as possible.
+//    For almost all values the string has the fewest digits that do this.
 //
 //    Return value: string
 // ----------------------------------------------------------------------
 PROTOBUF_EXPORT std::string SimpleDtoa(double value);
 PROTOBUF_EXPORT std::string SimpleFtoa(float value);
 
+// Sizes of the buffers required by DoubleToBuffer() and FloatToBuffer().
+constexpr int kDoubleToBufferSize = 32;
+constexpr int kFloatToBufferSize = 24;
+
+// Like SimpleDtoa() and SimpleFtoa(), but write the result into `buffer`,
+// followed by a NUL, without allocating. `buffer` must be at least
+// kDoubleToBufferSize or kFloatToBufferSize bytes long. Returns the length of
+// the result.
+PROTOBUF_EXPORT size_t DoubleToBuffer(double value, char* buffer);
+PROTOBUF_EXPORT size_t FloatToBuffer(float value, char* buffer);
+
 // A locale-independent version of the standard strtod(), which always
 // uses a dot as the decimal separator.
 PROTOBUF_EXPORT double NoLocaleStrtod(const char* str, char** endptr);
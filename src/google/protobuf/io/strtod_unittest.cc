@@ -0,0 +1,175 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/io/strtod.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <system_error>
+
+#include <gtest/gtest.h>
+#include "absl/strings/charconv.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+
+namespace google {
+namespace protobuf {
+namespace io {
+namespace {
+
+double BitsToDouble(uint64_t bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Returns the number of significant digits in `str`.
+int CountDigits(absl::string_view str) {
+  std::string digits;
+  for (char c : str.substr(0, str.find('e'))) {
+    if (c >= '0' && c <= '9') digits.push_back(c);
+  }
+  const size_t first = digits.find_first_not_of('0');
+  if (first == std::string::npos) return 0;
+  return static_cast<int>(digits.find_last_not_of('0') - first + 1);
+}
+
+// Checks that SimpleDtoa() round-trips `value` through NoLocaleStrtod() with
+// as few digits as possible.
+void ExpectShortestRoundTrip(double value) {
+  const std::string str = SimpleDtoa(value);
+  char* end;
+  EXPECT_EQ(NoLocaleStrtod(str.c_str(), &end), value) << str;
+  EXPECT_EQ(*end, '\0') << str;
+
+  const int digits = CountDigits(str);
+  if (digits > 1) {
+    const std::string shorter = absl::StrFormat("%.*g", digits - 1, value);
+    EXPECT_NE(NoLocaleStrtod(shorter.c_str(), nullptr), value)
+        << str << " can be printed as " << shorter;
+  }
+}
+
+void ExpectShortestRoundTrip(float value) {
+  const std::string str = SimpleFtoa(value);
+  float parsed;
+  auto result = absl::from_chars(str.data(), str.data() + str.size(), parsed);
+  EXPECT_EQ(result.ec, std::errc()) << str;
+  EXPECT_EQ(parsed, value) << str;
+
+  const int digits = CountDigits(str);
+  if (digits > 1) {
+    const std::string shorter = absl::StrFormat("%.*g", digits - 1, value);
+    absl::from_chars(shorter.data(), shorter.data() + shorter.size(), parsed);
+    EXPECT_NE(parsed, value) << str << " can be printed as " << shorter;
+  }
+}
+
+TEST(StrtodTest, DoubleLayout) {
+  // Values that round-trip with 15 digits are printed like "%.15g".
+  EXPECT_EQ(SimpleDtoa(0.1), "0.1");
+  EXPECT_EQ(SimpleDtoa(0.3), "0.3");
+  EXPECT_EQ(SimpleDtoa(-1.5), "-1.5");
+  EXPECT_EQ(SimpleDtoa(123456), "123456");
+  EXPECT_EQ(SimpleDtoa(0.0001), "0.0001");
+  EXPECT_EQ(SimpleDtoa(0.00001), "1e-05");
+  EXPECT_EQ(SimpleDtoa(1e14), "100000000000000");
+  EXPECT_EQ(SimpleDtoa(1e15), "1e+15");
+  EXPECT_EQ(SimpleDtoa(1e100), "1e+100");
+  // Others like "%.17g", with as few digits as round-trip.
+  EXPECT_EQ(SimpleDtoa(0.1 + 0.2), "0.30000000000000004");
+  EXPECT_EQ(SimpleDtoa(1e15 + 0.5), "1000000000000000.5");
+  EXPECT_EQ(SimpleDtoa(1e16 + 2), "10000000000000002");
+  EXPECT_EQ(SimpleDtoa(1e17 + 16), "1.0000000000000002e+17");
+}
+
+TEST(StrtodTest, DoubleSpecialValues) {
+  EXPECT_EQ(SimpleDtoa(0.0), "0");
+  EXPECT_EQ(SimpleDtoa(-0.0), "-0");
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::infinity()), "inf");
+  EXPECT_EQ(SimpleDtoa(-std::numeric_limits<double>::infinity()), "-inf");
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::quiet_NaN()), "nan");
+
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::max()),
+            "1.7976931348623157e+308");
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::lowest()),
+            "-1.7976931348623157e+308");
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::min()),
+            "2.2250738585072014e-308");
+  EXPECT_EQ(SimpleDtoa(std::numeric_limits<double>::denorm_min()), "5e-324");
+
+  // Subnormals, including the largest one.
+  ExpectShortestRoundTrip(std::numeric_limits<double>::denorm_min());
+  ExpectShortestRoundTrip(BitsToDouble(uint64_t{0x000FFFFFFFFFFFFF}));
+  ExpectShortestRoundTrip(BitsToDouble(uint64_t{0x0000000000012345}));
+  ExpectShortestRoundTrip(BitsToDouble(uint64_t{0x0008000000000001}));
+}
+
+TEST(StrtodTest, DoubleTies) {
+  // The shortest digits lie on or next to the boundary between two doubles,
+  // so Grisu3 gives up. 1e23 is exactly halfway and parses back to the double
+  // with an even significand.
+  EXPECT_EQ(SimpleDtoa(1e23), "1e+23");
+  EXPECT_EQ(SimpleDtoa(1e126), "1e+126");
+  EXPECT_EQ(SimpleDtoa(-1e23), "-1e+23");
+  ExpectShortestRoundTrip(1e23);
+  ExpectShortestRoundTrip(1e126);
+}
+
+TEST(StrtodTest, DoubleGrisu3Fallback) {
+  // Grisu3 gives up on these, and rounding the digits of the fallback to 16
+  // digits does not round-trip while truncating them does.
+  EXPECT_EQ(SimpleDtoa(6.137688561080735e-109), "6.137688561080735e-109");
+  EXPECT_EQ(SimpleDtoa(7.544728159223124e+152), "7.544728159223124e+152");
+  ExpectShortestRoundTrip(6.137688561080735e-109);
+  ExpectShortestRoundTrip(7.544728159223124e+152);
+}
+
+TEST(StrtodTest, DoubleRandomRoundTrip) {
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 100000; ++i) {
+    const double value = BitsToDouble(random());
+    if (!std::isfinite(value)) continue;
+    ExpectShortestRoundTrip(value);
+  }
+}
+
+TEST(StrtodTest, FloatSpecialValues) {
+  EXPECT_EQ(SimpleFtoa(0.1f), "0.1");
+  EXPECT_EQ(SimpleFtoa(1.5f), "1.5");
+  EXPECT_EQ(SimpleFtoa(0.0f), "0");
+  EXPECT_EQ(SimpleFtoa(-0.0f), "-0");
+  EXPECT_EQ(SimpleFtoa(std::numeric_limits<float>::infinity()), "inf");
+  EXPECT_EQ(SimpleFtoa(-std::numeric_limits<float>::infinity()), "-inf");
+  EXPECT_EQ(SimpleFtoa(std::numeric_limits<float>::quiet_NaN()), "nan");
+
+  EXPECT_EQ(SimpleFtoa(std::numeric_limits<float>::max()), "3.4028235e+38");
+  EXPECT_EQ(SimpleFtoa(std::numeric_limits<float>::min()), "1.1754944e-38");
+  EXPECT_EQ(SimpleFtoa(std::numeric_limits<float>::denorm_min()), "1e-45");
+}
+
+TEST(StrtodTest, FloatRoundTripSweep) {
+  // Every 997th positive float, which covers all exponents.
+  for (uint32_t bits = 1; bits < 0x7F800000; bits += 997) {
+    ExpectShortestRoundTrip(BitsToFloat(bits));
+  }
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace protobuf
+}  // namespace google
@@ -67,6 +67,8 @@
 
 #include "google/protobuf/io/tokenizer.h"
 
+#include <utility>
+
 #include "google/protobuf/stubs/common.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
@@ -356,10 +358,31 @@ inline bool Tokenizer::TryConsume(char c) {
 template <typename CharacterClass>
 inline void Tokenizer::ConsumeZeroOrMore() {
   while (CharacterClass::InClass(current_char_)) {
-    NextChar();
+    if (current_char_ == '\n' || current_char_ == '\t') {
+      NextChar();
+      continue;
+    }
+    ConsumeRunInBuffer([](char c) {
+      return CharacterClass::InClass(c) && c != '\n' && c != '\t';
+    });
   }
 }
 
+template <typename Predicate>
+inline void Tokenizer::ConsumeRunInBuffer(Predicate predicate) {
+  int end = buffer_pos_ + 1;
+  while (end < buffer_size_ && predicate(buffer_[end])) {
+    ++end;
+  }
+  // None of the skipped characters is a newline or a tab, so each of them
+  // advances the column by one. NextChar() consumes the last one and loads
+  // the next buffer if needed.
+  column_ += end - 1 - buffer_pos_;
+  buffer_pos_ = end - 1;
+  current_char_ = buffer_[buffer_pos_];
+  NextChar();
+}
+
 template <typename CharacterClass>
 inline void Tokenizer::ConsumeOneOrMore(const char* error) {
   if (!CharacterClass::InClass(current_char_)) {
@@ -433,7 +456,14 @@ void Tokenizer::ConsumeString(char delimiter) {
           NextChar();
           return;
         }
-        NextChar();
+        if (current_char_ == '\t') {
+          NextChar();
+          break;
+        }
+        ConsumeRunInBuffer([delimiter](char c) {
+          return c != delimiter && c != '\\' && c != '\n' && c != '\t' &&
+                 c != '\0';
+        });
         break;
       }
     }
@@ -499,7 +529,12 @@ void Tokenizer::ConsumeLineComment(std::string* content) {
   if (content != NULL) RecordTo(content);
 
   while (current_char_ != '\0' && current_char_ != '\n') {
-    NextChar();
+    if (current_char_ == '\t') {
+      NextChar();
+      continue;
+    }
+    ConsumeRunInBuffer(
+        [](char c) { return c != '\0' && c != '\n' && c != '\t'; });
   }
   TryConsume('\n');
 
@@ -607,7 +642,9 @@ bool Tokenizer::TryConsumeNewline() {
 // -------------------------------------------------------------------
 
 bool Tokenizer::Next() {
-  previous_ = current_;
+  // Every path below overwrites all of current_, so swapping is enough and
+  // lets both tokens keep the capacity of their text.
+  std::swap(previous_, current_);
 
   while (!read_error_) {
     StartToken();
@@ -1228,7 +1265,14 @@ void Tokenizer::ParseStringAppend(const std::string& text,
     } else if (*ptr == text[0] && ptr[1] == '\0') {
       // Ignore final quote matching the starting quote.
     } else {
-      output->push_back(*ptr);
+      // Copy the characters up to the next escape or the final quote at once.
+      const char* run_end = ptr + 1;
+      while (*run_end != '\0' && *run_end != '\\' &&
+             !(*run_end == text[0] && run_end[1] == '\0')) {
+        ++run_end;
+      }
+      output->append(ptr, run_end - ptr);
+      ptr = run_end - 1;  // Because we're about to ++ptr.
     }
   }
 }
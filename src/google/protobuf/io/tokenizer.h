@@ -404,6 +404,12 @@ class PROTOBUF_EXPORT Tokenizer {
   // e.g. ConsumeOneOrMore<Digit>("Expected digits.");
   template <typename CharacterClass>
   inline void ConsumeOneOrMore(const char* error);
+
+  // Consume the current character and the ones following it in the current
+  // buffer for which `predicate` holds.  The current character must satisfy
+  // `predicate`, which must reject '\n' and '\t'.
+  template <typename Predicate>
+  inline void ConsumeRunInBuffer(Predicate predicate);
 };
 
 // inline methods ====================================================
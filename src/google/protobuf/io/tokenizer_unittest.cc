@@ -404,6 +404,16 @@ MultiTokenCase kMultiTokenCases[] = {
          {Tokenizer::TYPE_END, "", 0, 16, 16},
      }},
 
+    // Test that runs of plain characters between escapes, tabs and comments
+    // keep column numbers correct.
+    {"\"ab\\ncd\tef\" x // a\tb\ny",
+     {
+         {Tokenizer::TYPE_STRING, "\"ab\\ncd\tef\"", 0, 0, 11},
+         {Tokenizer::TYPE_IDENTIFIER, "x", 0, 12, 13},
+         {Tokenizer::TYPE_IDENTIFIER, "y", 1, 0, 1},
+         {Tokenizer::TYPE_END, "", 1, 1, 1},
+     }},
+
     // Test that line comments are ignored.
     {"foo // This is a comment\n"
      "bar // This is another comment",
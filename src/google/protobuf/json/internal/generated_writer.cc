@@ -0,0 +1,94 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/json/internal/generated_writer.h"
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/json/internal/unparser.h"
+#include "google/protobuf/json/internal/writer.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace json_internal {
+
+// Every method mirrors what the reflective writer in unparser.cc does for the
+// same value.
+
+GeneratedJsonWriter::GeneratedJsonWriter(std::string* output)
+    : stream_(output), writer_(&stream_, DefaultWriterOptions()) {}
+
+GeneratedJsonWriter::~GeneratedJsonWriter() = default;
+
+void GeneratedJsonWriter::WriteRaw(absl::string_view str) {
+  writer_.Write(str);
+}
+
+void GeneratedJsonWriter::WriteComma(bool& first) { writer_.WriteComma(first); }
+
+void GeneratedJsonWriter::WriteKey(absl::string_view name) {
+  writer_.Write(MakeQuoted(name), ":");
+}
+
+void GeneratedJsonWriter::WriteBool(bool value) {
+  writer_.Write(value ? "true" : "false");
+}
+
+void GeneratedJsonWriter::WriteInt32(int32_t value) { writer_.Write(value); }
+
+void GeneratedJsonWriter::WriteUInt32(uint32_t value) { writer_.Write(value); }
+
+void GeneratedJsonWriter::WriteInt64(int64_t value) {
+  writer_.Write(MakeQuoted(value));
+}
+
+void GeneratedJsonWriter::WriteUInt64(uint64_t value) {
+  writer_.Write(MakeQuoted(value));
+}
+
+void GeneratedJsonWriter::WriteFloat(float value) { writer_.Write(value); }
+
+void GeneratedJsonWriter::WriteDouble(double value) { writer_.Write(value); }
+
+void GeneratedJsonWriter::WriteString(absl::string_view value) {
+  writer_.Write(MakeQuoted(value));
+}
+
+void GeneratedJsonWriter::WriteBytes(absl::string_view value) {
+  writer_.WriteBase64(value);
+}
+
+void GeneratedJsonWriter::WriteEnum(absl::string_view name, int32_t number) {
+  if (name.empty()) {
+    writer_.Write(number);
+  } else {
+    writer_.Write("\"", name, "\"");
+  }
+}
+
+absl::Status GeneratedJsonWriter::WriteMessage(const Message& message) {
+  return WriteMessageWithReflection(writer_, message);
+}
+
+absl::Status GeneratedJsonWriter::WriteMapField(const Message& message,
+                                                const FieldDescriptor& field) {
+  return WriteMapWithReflection(writer_, message, field);
+}
+
+}  // namespace json_internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
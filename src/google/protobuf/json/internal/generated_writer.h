@@ -0,0 +1,85 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#ifndef GOOGLE_PROTOBUF_JSON_INTERNAL_GENERATED_WRITER_H__
+#define GOOGLE_PROTOBUF_JSON_INTERNAL_GENERATED_WRITER_H__
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/json/internal/writer.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace json_internal {
+
+// The writer that code generated with the json_codegen option writes JSON
+// through. It produces exactly what json::MessageToJsonString() produces with
+// the default json::PrintOptions, provided that the generated code writes
+// fields in the same order and with the same keys.
+//
+// The output is appended to the string passed to the constructor and is only
+// complete once the writer has been destroyed.
+//
+// This is an implementation detail of generated code; do not use it directly.
+class PROTOBUF_EXPORT GeneratedJsonWriter {
+ public:
+  explicit GeneratedJsonWriter(std::string* output);
+  GeneratedJsonWriter(const GeneratedJsonWriter&) = delete;
+  GeneratedJsonWriter& operator=(const GeneratedJsonWriter&) = delete;
+  ~GeneratedJsonWriter();
+
+  // Writes `str` as it is. Generated code uses this for punctuation and for
+  // field keys quoted and escaped at compile time.
+  void WriteRaw(absl::string_view str);
+  // Writes a comma unless `first` is set, and clears `first`.
+  void WriteComma(bool& first);
+  // Writes `name` quoted and escaped, followed by a colon.
+  void WriteKey(absl::string_view name);
+
+  void WriteBool(bool value);
+  void WriteInt32(int32_t value);
+  void WriteUInt32(uint32_t value);
+  // 64-bit integers are quoted.
+  void WriteInt64(int64_t value);
+  void WriteUInt64(uint64_t value);
+  void WriteFloat(float value);
+  void WriteDouble(double value);
+  void WriteString(absl::string_view value);
+  // Writes `value` base64 encoded.
+  void WriteBytes(absl::string_view value);
+  // Writes the enum value `name`, or `number` if the value has no name.
+  void WriteEnum(absl::string_view name, int32_t number);
+
+  // Writes `message` through reflection, for message types that have no
+  // generated JSON writer.
+  absl::Status WriteMessage(const Message& message);
+  // Writes the map field `field` of `message` through reflection, which
+  // determines the order of the entries.
+  absl::Status WriteMapField(const Message& message,
+                             const FieldDescriptor& field);
+
+ private:
+  io::StringOutputStream stream_;
+  JsonWriter writer_;
+};
+
+}  // namespace json_internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_JSON_INTERNAL_GENERATED_WRITER_H__
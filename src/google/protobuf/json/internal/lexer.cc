@@ -13,6 +13,7 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <ostream>
@@ -32,6 +33,10 @@
 #include "utf8_validity.h"
 #include "google/protobuf/stubs/status_macros.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // Must be included last.
 #include "google/protobuf/port_def.inc"
 
@@ -76,6 +81,74 @@ void HardenAgainstHyrumsLaw(absl::string_view to_obfuscate, std::string& out) {
     }
   }
 }
+
+// Returns whether `c` can be copied verbatim out of a string literal: that
+// is, whether it is printable ASCII other than a quote or a backslash.
+bool IsPlainStringChar(char c) {
+  uint8_t uc = static_cast<uint8_t>(c);
+  return uc >= 0x20 && uc < 0x80 && c != '"' && c != '\'' && c != '\\';
+}
+
+// Returns the length of the longest prefix of `data` for which
+// IsPlainStringChar() holds. Quotes, escapes, control characters and
+// non-ASCII bytes that need UTF-8 handling all end the run.
+//
+// This is the hot loop of string parsing, so it looks at 16 bytes at a time
+// with SSE2 and at 8 bytes at a time elsewhere.
+size_t PlainStringPrefix(absl::string_view data) {
+  const char* p = data.data();
+  const char* end = p + data.size();
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i apostrophe = _mm_set1_epi8('\'');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(' ');
+  while (end - p >= 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // As signed bytes, both control characters and non-ASCII bytes compare
+    // less than ' '.
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, quote),
+                     _mm_cmpeq_epi8(bytes, apostrophe)),
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, backslash),
+                     _mm_cmplt_epi8(bytes, space)));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+    if (mask != 0) {
+      return static_cast<size_t>(p - data.data()) + absl::countr_zero(mask);
+    }
+    p += 16;
+  }
+#else
+  constexpr uint64_t kOnes = 0x0101010101010101;
+  constexpr uint64_t kHighBits = 0x8080808080808080;
+  // Sets the high bit of every byte of `word` that is zero, plus possibly
+  // some bytes after it; this is only used to find whether any byte is.
+  auto has_zero = [](uint64_t word) { return (word - kOnes) & ~word; };
+  while (end - p >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    uint64_t special = has_zero(word ^ (kOnes * '"')) |
+                       has_zero(word ^ (kOnes * '\'')) |
+                       has_zero(word ^ (kOnes * '\\')) |
+                       ((word - kOnes * ' ') & ~word) | word;
+    if ((special & kHighBits) != 0) break;
+    p += 8;
+  }
+#endif
+  while (p != end && IsPlainStringChar(*p)) ++p;
+  return static_cast<size_t>(p - data.data());
+}
+
+// Unescaped strings larger than this are not kept for reuse, so that one large
+// string does not pin memory to the thread.
+constexpr size_t kMaxRetainedUnescapeBufferSize = 1 << 16;
+
+// Returns the buffer that strings are unescaped into when parsing onto an
+// arena; they are copied onto the arena once complete.
+std::string& ThreadUnescapeBuffer() {
+  thread_local std::string buffer;
+  return buffer;
+}
 }  // namespace
 
 constexpr size_t ParseOptions::kDefaultDepth;
@@ -191,20 +264,29 @@ absl::StatusOr<uint16_t> JsonLexer::ParseU16HexCodepoint() {
 absl::Status JsonLexer::SkipToToken() {
   while (true) {
     RETURN_IF_ERROR(stream_.BufferAtLeast(1).status());
-    switch (stream_.PeekChar()) {
-      case '\n':
-        RETURN_IF_ERROR(Advance(1));
-        ++json_loc_.line;
-        json_loc_.col = 0;
-        break;
-      case '\r':
-      case '\t':
-      case ' ':
-        RETURN_IF_ERROR(Advance(1));
-        break;
-      default:
-        return absl::OkStatus();
+    // Scan the buffered bytes directly instead of advancing one byte at a
+    // time, since indentation makes whitespace runs common.
+    absl::string_view unread = stream_.Unread();
+    size_t n = 0;
+    while (n < unread.size()) {
+      switch (unread[n]) {
+        case '\n':
+          RETURN_IF_ERROR(Advance(n + 1));
+          ++json_loc_.line;
+          json_loc_.col = 0;
+          unread.remove_prefix(n + 1);
+          n = 0;
+          break;
+        case '\r':
+        case '\t':
+        case ' ':
+          ++n;
+          break;
+        default:
+          return Advance(n);
+      }
     }
+    RETURN_IF_ERROR(Advance(n));
   }
 }
 
@@ -387,12 +469,28 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseUtf8() {
   JsonLocation loc = json_loc_;
   RETURN_IF_ERROR(Expect(is_single_quote ? "'" : "\""));
 
-  // on_heap is empty if we do not need to heap-allocate the string.
-  std::string on_heap;
+  // on_heap is empty if we do not need to heap-allocate the string. When
+  // parsing onto an arena, a per-thread buffer is used instead.
+  std::string local_buffer;
+  std::string& on_heap = options_.arena != nullptr ? ThreadUnescapeBuffer()
+                                                   : local_buffer;
+  on_heap.clear();
   LocationWith<Mark> mark = BeginMark();
   while (true) {
     RETURN_IF_ERROR(stream_.BufferAtLeast(1).status());
 
+    // Most of a string is usually plain ASCII which needs no escaping or
+    // UTF-8 handling; consume such runs in bulk.
+    absl::string_view unread = stream_.Unread();
+    size_t plain = PlainStringPrefix(unread);
+    if (plain != 0) {
+      if (!on_heap.empty()) {
+        on_heap.append(unread.data(), plain);
+      }
+      RETURN_IF_ERROR(Advance(plain));
+      continue;
+    }
+
     char c = stream_.PeekChar();
     RETURN_IF_ERROR(Advance(1));
     switch (c) {
@@ -403,9 +501,14 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseUtf8() {
         }
 
         // NOTE: the 1 below clips off the " from the end of the string.
-        MaybeOwnedString result = on_heap.empty()
-                                      ? mark.value.UpToUnread(1)
-                                      : MaybeOwnedString{std::move(on_heap)};
+        MaybeOwnedString result =
+            on_heap.empty() ? mark.value.UpToUnread(1)
+            : options_.arena != nullptr
+                ? MaybeOwnedString(on_heap, options_.arena)
+                : MaybeOwnedString{std::move(on_heap)};
+        if (on_heap.capacity() > kMaxRetainedUnescapeBufferSize) {
+          std::string().swap(on_heap);
+        }
         if (utf8_range::IsStructurallyValid(result)) {
           return LocationWith<MaybeOwnedString>{std::move(result), loc};
         }
@@ -414,7 +517,8 @@ absl::StatusOr<LocationWith<MaybeOwnedString>> JsonLexer::ParseUtf8() {
       case '\\': {
         if (on_heap.empty()) {
           // The 1 skips over the `\`.
-          on_heap = std::string(mark.value.UpToUnread(1).AsView());
+          absl::string_view prefix = mark.value.UpToUnread(1).AsView();
+          on_heap.assign(prefix.data(), prefix.size());
           // Clang-tidy incorrectly notes this as being moved-from multiple
           // times, but it can only occur in one loop iteration. The mark is
           // destroyed only if we need to handle an escape when on_heap is
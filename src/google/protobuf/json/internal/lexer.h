@@ -24,6 +24,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/json/internal/message_path.h"
@@ -56,6 +57,11 @@ struct ParseOptions {
   // in the unit tests; we intend to remove this setting eventually. See
   // b/234868512.
   bool allow_legacy_syntax = false;
+
+  // If set, strings that cannot be viewed in the input are copied onto this
+  // arena rather than into heap-allocated std::strings, and scratch buffers
+  // are reused per thread.
+  Arena* arena = nullptr;
 };
 
 // A position in JSON input, for error context.
@@ -100,7 +106,10 @@ class JsonLexer {
 
   JsonLexer(io::ZeroCopyInputStream* stream, const ParseOptions& options,
             MessagePath* path = nullptr, JsonLocation start = {})
-      : stream_(stream), options_(options), json_loc_(start), path_(path) {
+      : stream_(stream, /*reuse_thread_buffer=*/options.arena != nullptr),
+        options_(options),
+        json_loc_(start),
+        path_(path) {
     json_loc_.path = path_;
   }
 
@@ -613,6 +613,26 @@ TEST(LexerTest, MixtureOfEscapesAndRawMultibyteCharacters) {
   });
 }
 
+TEST(LexerTest, LongPlainRunsWithEscapes) {
+  Do(R"json("abcdefghijklmnopqrstuvwxyz\"0123456789'ABCDEFGHIJ\u00e9é")json",
+     [](io::ZeroCopyInputStream* stream) {
+       EXPECT_THAT(Value::Parse(stream),
+                   IsOkAndHolds(ValueIs<std::string>(
+                       "abcdefghijklmnopqrstuvwxyz\"0123456789'"
+                       "ABCDEFGHIJéé")));
+     });
+  BadInner("\"abcdefghijklmnopqrstuvwxyz\x01"
+           "ghijklmnopqrstuvwxyz\"");
+}
+
+TEST(LexerTest, IndentedArray) {
+  Do("[\n    1,\r\n\t  22\n]\n", [](io::ZeroCopyInputStream* stream) {
+    EXPECT_THAT(Value::Parse(stream),
+                IsOkAndHolds(ValueIs<Value::Array>(
+                    ElementsAre(ValueIs<double>(1), ValueIs<double>(22)))));
+  });
+}
+
 TEST(LexerTest, SurrogateEscape) {
   absl::string_view json = R"json(
     [ "\ud83d\udc08\u200D\u2b1B\ud83d\uDdA4" ]
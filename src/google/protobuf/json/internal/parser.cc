@@ -19,6 +19,7 @@
 #include "google/protobuf/type.pb.h"
 #include "absl/base/attributes.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
@@ -32,6 +33,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/dynamic_message.h"
 #include "google/protobuf/io/zero_copy_sink.h"
@@ -303,22 +305,21 @@ absl::StatusOr<double> ParseFp(JsonLexer& lex, Field<Traits> field) {
 }
 
 template <typename Traits>
-absl::StatusOr<std::string> ParseStrOrBytes(JsonLexer& lex,
-                                            Field<Traits> field) {
+absl::StatusOr<MaybeOwnedString> ParseStrOrBytes(JsonLexer& lex,
+                                                 Field<Traits> field) {
   absl::StatusOr<LocationWith<MaybeOwnedString>> str = lex.ParseUtf8();
   RETURN_IF_ERROR(str.status());
 
   if (Traits::FieldType(field) == FieldDescriptor::TYPE_BYTES) {
-    std::string& b64 = str->value.ToString();
     absl::StatusOr<absl::Span<char>> decoded =
-        DecodeBase64InPlace(absl::MakeSpan(&b64[0], b64.size()));
+        DecodeBase64InPlace(str->value.ToMutableSpan(lex.options().arena));
     if (!decoded.ok()) {
       return str->loc.Invalid(decoded.status().message());
     }
-    b64.resize(decoded->size());
+    str->value.Truncate(decoded->size());
   }
 
-  return std::move(str->value.ToString());
+  return std::move(str->value);
 }
 
 template <typename Traits>
@@ -498,7 +499,7 @@ absl::Status ParseSingular(JsonLexer& lex, Field<Traits> field,
     case FieldDescriptor::TYPE_BYTES: {
       auto x = ParseStrOrBytes<Traits>(lex, field);
       RETURN_IF_ERROR(x.status());
-      Traits::SetString(field, msg, *x);
+      Traits::SetString(field, msg, x->AsView());
       break;
     }
     case FieldDescriptor::TYPE_ENUM: {
@@ -700,8 +701,7 @@ absl::Status ParseMap(JsonLexer& lex, Field<Traits> field, Msg<Traits>& msg) {
                   break;
                 }
                 case FieldDescriptor::TYPE_STRING: {
-                  Traits::SetString(key_field, entry,
-                                    std::move(key.value.ToString()));
+                  Traits::SetString(key_field, entry, key.value.AsView());
                   break;
                 }
                 default:
@@ -1068,7 +1068,7 @@ absl::Status ParseValue(JsonLexer& lex, const Desc<Traits>& desc,
 
       auto str = lex.ParseUtf8();
       RETURN_IF_ERROR(str.status());
-      Traits::SetString(field, msg, std::move(str->value.ToString()));
+      Traits::SetString(field, msg, str->value.AsView());
       break;
     }
     case JsonLexer::kFalse:
@@ -1266,7 +1266,9 @@ absl::Status ParseMessage(JsonLexer& lex, const Desc<Traits>& desc,
           }
         }
 
-        return ParseField<Traits>(lex, desc, name.value.ToString(), msg);
+        // The name must outlive buffering while the value is parsed.
+        return ParseField<Traits>(
+            lex, desc, name.value.ToStableView(lex.options().arena), msg);
       });
 }
 }  // namespace
@@ -1293,6 +1295,47 @@ absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
   return s;
 }
 
+absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    absl::FunctionRef<absl::Status(Message&)> callback,
+    json_internal::ParseOptions options) {
+  // Every record is parsed into a fresh message on the same arena, which is
+  // reset in between, so memory use is bounded by the largest record rather
+  // than by the whole input. The temporary strings of the lexer go on that
+  // arena too, rather than on `options.arena`, which is never reset here.
+  Arena arena;
+  options.arena = &arena;
+  MessagePath path(prototype.GetDescriptor()->full_name());
+  JsonLexer lex(input, options, &path);
+
+  auto parse_record = [&]() -> absl::Status {
+    arena.Reset();
+    Message* message = prototype.New(&arena);
+    ParseProto2Descriptor::Msg msg(message);
+    RETURN_IF_ERROR(ParseMessage<ParseProto2Descriptor>(
+        lex, *message->GetDescriptor(), msg, /*any_reparse=*/false));
+    return callback(*message);
+  };
+
+  if (lex.AtEof()) {
+    return absl::OkStatus();
+  }
+
+  if (lex.Peek(JsonLexer::kArr)) {
+    RETURN_IF_ERROR(lex.VisitArray(parse_record));
+    if (!lex.AtEof()) {
+      return absl::InvalidArgumentError(
+          "extraneous characters after end of JSON array");
+    }
+    return absl::OkStatus();
+  }
+
+  do {
+    RETURN_IF_ERROR(parse_record());
+  } while (!lex.AtEof());
+  return absl::OkStatus();
+}
+
 absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
                                 io::ZeroCopyInputStream* json_input,
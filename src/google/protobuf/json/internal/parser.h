@@ -10,6 +10,8 @@
 
 #include <string>
 
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "google/protobuf/json/internal/lexer.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/util/type_resolver.h"
@@ -22,6 +24,12 @@ namespace json_internal {
 absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
                                  Message* message,
                                  json_internal::ParseOptions options);
+// Internal version of google::protobuf::json::JsonStreamToMessages; see json.h for
+// details.
+absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    absl::FunctionRef<absl::Status(Message&)> callback,
+    json_internal::ParseOptions options);
 // Internal version of google::protobuf::util::JsonToBinaryStream; see json_util.h for
 // details.
 absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
@@ -122,9 +122,23 @@ struct ParseProto2Descriptor : Proto2Descriptor {
     RecordAsSeen(f, msg);
     return WithDynamicType(
         *f->containing_type(), type_url, [&](const Desc& desc) -> absl::Status {
+          // Generated types do not need a DynamicMessageFactory, which would
+          // build the type's layout from scratch on every call.
           DynamicMessageFactory factory;
-          std::unique_ptr<Message> dynamic(factory.GetPrototype(&desc)->New());
-          Msg wrapper(dynamic.get());
+          const Message* prototype = nullptr;
+          if (desc.file()->pool() == DescriptorPool::generated_pool()) {
+            prototype =
+                MessageFactory::generated_factory()->GetPrototype(&desc);
+          }
+          if (prototype == nullptr) {
+            prototype = factory.GetPrototype(&desc);
+          }
+          // The payload is built on the arena of the message being parsed, if
+          // any.
+          Arena* arena = msg.msg_->GetArena();
+          Message* dynamic = prototype->New(arena);
+          std::unique_ptr<Message> owned(arena == nullptr ? dynamic : nullptr);
+          Msg wrapper(dynamic);
           RETURN_IF_ERROR(body(desc, wrapper));
 
           if (f->is_repeated()) {
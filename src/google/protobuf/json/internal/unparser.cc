@@ -845,43 +845,57 @@ absl::Status MessageToJsonString(const Message& message, std::string* output,
   return absl::OkStatus();
 }
 
+absl::Status WriteMessageWithReflection(JsonWriter& writer,
+                                        const Message& message) {
+  return WriteMessage<UnparseProto2Descriptor>(writer, message,
+                                               *message.GetDescriptor());
+}
+
+absl::Status WriteMapWithReflection(JsonWriter& writer, const Message& message,
+                                    const FieldDescriptor& field) {
+  return WriteMap<UnparseProto2Descriptor>(writer, message, &field);
+}
+
 absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& type_url,
                                 io::ZeroCopyInputStream* binary_input,
                                 io::ZeroCopyOutputStream* json_output,
                                 json_internal::WriterOptions options) {
-  // NOTE: Most of the contortions in this function are to allow for capture of
-  // input and output of the parser in ABSL_DLOG mode. Destruction order is very
-  // critical in this function, because io::ZeroCopy*Stream types usually only
-  // flush on destruction.
-
-  // For ABSL_DLOG, we would like to print out the input and output, which
-  // requires buffering both instead of doing "zero copy". This block, and the
-  // one at the end of the function, set up and tear down interception of the
-  // input and output streams.
-  std::string copy;
+  // UntypedMessage refers to string and bytes fields in place rather than
+  // copying each of them, which requires a flat input buffer.
+  std::string input;
+  const void* data;
+  int len;
+  while (binary_input->Next(&data, &len)) {
+    input.append(static_cast<const char*>(data), len);
+  }
+  return BinaryToJsonStream(resolver, type_url, input, json_output, options);
+}
+
+absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
+                                const std::string& type_url,
+                                absl::string_view binary_input,
+                                io::ZeroCopyOutputStream* json_output,
+                                json_internal::WriterOptions options) {
+  // NOTE: Destruction order is very critical in this function, because
+  // io::ZeroCopy*Stream types usually only flush on destruction.
+
+  // For ABSL_DLOG, we would like to print out the output, which requires
+  // buffering it instead of doing "zero copy". This block, and the one at the
+  // end of the function, set up and tear down interception of the output
+  // stream.
   std::string out;
-  absl::optional<io::ArrayInputStream> tee_input;
   absl::optional<io::StringOutputStream> tee_output;
   if (PROTOBUF_DEBUG) {
-    const void* data;
-    int len;
-    while (binary_input->Next(&data, &len)) {
-      copy.resize(copy.size() + len);
-      std::memcpy(&copy[copy.size() - len], data, len);
-    }
-    tee_input.emplace(copy.data(), copy.size());
     tee_output.emplace(&out);
-    ABSL_DLOG(INFO) << "json2/input: " << absl::BytesToHexString(copy);
+    ABSL_DLOG(INFO) << "json2/input: " << absl::BytesToHexString(binary_input);
   }
 
   ResolverPool pool(resolver);
   auto desc = pool.FindMessage(type_url);
   RETURN_IF_ERROR(desc.status());
 
-  io::CodedInputStream stream(tee_input.has_value() ? &*tee_input
-                                                    : binary_input);
-  auto msg = UntypedMessage::ParseFromStream(*desc, stream);
+  auto msg = UntypedMessage::ParseFromBuffer(*desc, binary_input);
   RETURN_IF_ERROR(msg.status());
 
   JsonWriter writer(tee_output.has_value() ? &*tee_output : json_output,
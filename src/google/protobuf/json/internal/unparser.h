@@ -11,6 +11,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "google/protobuf/descriptor.h"
 #include "google/protobuf/json/internal/writer.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/util/type_resolver.h"
@@ -29,6 +30,31 @@ absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
                                 io::ZeroCopyInputStream* binary_input,
                                 io::ZeroCopyOutputStream* json_output,
                                 json_internal::WriterOptions options);
+// Like the above, but reads the binary proto from a buffer, which avoids
+// copying the input.
+absl::Status BinaryToJsonStream(google::protobuf::util::TypeResolver* resolver,
+                                const std::string& type_url,
+                                absl::string_view binary_input,
+                                io::ZeroCopyOutputStream* json_output,
+                                json_internal::WriterOptions options);
+
+// The WriterOptions that json::MessageToJsonString() uses for the default
+// json::PrintOptions. GeneratedJsonWriter writes with these options.
+inline WriterOptions DefaultWriterOptions() {
+  WriterOptions options;
+  options.allow_legacy_syntax = true;
+  return options;
+}
+
+// Writes `message` as a JSON value through reflection. GeneratedJsonWriter
+// calls this for message types that have no generated JSON writer.
+absl::Status WriteMessageWithReflection(JsonWriter& writer,
+                                        const Message& message);
+
+// Writes the map field `field` of `message` as a JSON object through
+// reflection, in the order of the repeated field backing the map.
+absl::Status WriteMapWithReflection(JsonWriter& writer, const Message& message,
+                                    const FieldDescriptor& field);
 }  // namespace json_internal
 }  // namespace protobuf
 }  // namespace google
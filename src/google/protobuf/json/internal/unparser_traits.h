@@ -385,7 +385,7 @@ struct UnparseProto3Type : Proto3Type {
                                                      std::string& scratch,
                                                      const Msg& msg,
                                                      size_t idx = 0) {
-    return msg.Get<std::string>(f->proto().number())[idx];
+    return msg.Get<absl::string_view>(f->proto().number())[idx];
   }
 
   static absl::StatusOr<const Msg*> GetMessage(Field f, const Msg& msg,
@@ -396,9 +396,7 @@ struct UnparseProto3Type : Proto3Type {
   template <typename F>
   static absl::Status WithDecodedMessage(const Desc& desc,
                                          absl::string_view data, F body) {
-    io::CodedInputStream stream(reinterpret_cast<const uint8_t*>(data.data()),
-                                data.size());
-    auto unerased = Msg::ParseFromStream(&desc, stream);
+    auto unerased = Msg::ParseFromBuffer(&desc, data);
     RETURN_IF_ERROR(unerased.status());
 
     // Explicitly create a const reference, so that we do not accidentally pass
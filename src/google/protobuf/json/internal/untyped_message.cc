@@ -201,6 +201,23 @@ PROTOBUF_NOINLINE static absl::Status MakeTooDeepError() {
   return absl::InvalidArgumentError("allowed depth exceeded");
 }
 
+// Returns the next `size` bytes of `stream` in place and skips over them.
+// `stream` must read from a flat array, so that the bytes stay valid.
+static bool ReadStringView(io::CodedInputStream& stream, int size,
+                           absl::string_view* out) {
+  if (size == 0) {
+    *out = absl::string_view();
+    return true;
+  }
+  const void* data;
+  int available;
+  if (!stream.GetDirectBufferPointer(&data, &available) || available < size) {
+    return false;
+  }
+  *out = absl::string_view(static_cast<const char*>(data), size);
+  return stream.Skip(size);
+}
+
 absl::Status UntypedMessage::Decode(io::CodedInputStream& stream,
                                     absl::optional<int32_t> current_group) {
   std::vector<int32_t> group_stack;
@@ -463,8 +480,8 @@ absl::Status UntypedMessage::DecodeDelimited(io::CodedInputStream& stream,
   switch (field.proto().kind()) {
     case Field::TYPE_STRING:
     case Field::TYPE_BYTES: {
-      std::string buf;
-      if (!stream.ReadString(&buf, stream.BytesUntilLimit())) {
+      absl::string_view buf;
+      if (!ReadStringView(stream, stream.BytesUntilLimit(), &buf)) {
         return MakeUnexpectedEofError();
       }
       if (field.proto().kind() == Field::TYPE_STRING) {
@@ -474,7 +491,7 @@ absl::Status UntypedMessage::DecodeDelimited(io::CodedInputStream& stream,
         }
       }
 
-      RETURN_IF_ERROR(InsertField(field, std::move(buf)));
+      RETURN_IF_ERROR(InsertField(field, buf));
       break;
     }
     case Field::TYPE_MESSAGE: {
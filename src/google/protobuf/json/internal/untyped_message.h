@@ -141,18 +141,22 @@ class ResolverPool {
 
 // A parsed wire-format proto that uses TypeReslover for parsing.
 //
+// String and bytes fields are not copied: they refer directly into the buffer
+// the message was parsed from, which must outlive the message.
+//
 // This type is an implementation detail of the JSON parser.
 class UntypedMessage final {
  public:
   // New nominal type instead of `bool` to avoid vector<bool> shenanigans.
   enum Bool : unsigned char { kTrue, kFalse };
   using Value = absl::variant<Bool, int32_t, uint32_t, int64_t, uint64_t, float,
-                              double, std::string, UntypedMessage,
+                              double, absl::string_view, UntypedMessage,
                               //
                               std::vector<Bool>, std::vector<int32_t>,
                               std::vector<uint32_t>, std::vector<int64_t>,
                               std::vector<uint64_t>, std::vector<float>,
-                              std::vector<double>, std::vector<std::string>,
+                              std::vector<double>,
+                              std::vector<absl::string_view>,
                               std::vector<UntypedMessage>>;
 
   UntypedMessage(const UntypedMessage&) = delete;
@@ -160,12 +164,13 @@ class UntypedMessage final {
   UntypedMessage(UntypedMessage&&) = default;
   UntypedMessage& operator=(UntypedMessage&&) = default;
 
-  // Tries to parse a proto with the given descriptor from an input stream.
-  static absl::StatusOr<UntypedMessage> ParseFromStream(
-      const ResolverPool::Message* desc, io::CodedInputStream& stream) {
-    UntypedMessage msg(std::move(desc));
-    RETURN_IF_ERROR(msg.Decode(stream));
-    return std::move(msg);
+  // Tries to parse a proto with the given descriptor from a buffer, which must
+  // outlive the returned message.
+  static absl::StatusOr<UntypedMessage> ParseFromBuffer(
+      const ResolverPool::Message* desc, absl::string_view data) {
+    io::CodedInputStream stream(reinterpret_cast<const uint8_t*>(data.data()),
+                                static_cast<int>(data.size()));
+    return ParseFromStream(desc, stream);
   }
 
   // Returns the number of elements in a field by number.
@@ -211,6 +216,15 @@ class UntypedMessage final {
 
   explicit UntypedMessage(const ResolverPool::Message* desc) : desc_(desc) {}
 
+  // `stream` must read from a flat array, so that string and bytes fields can
+  // refer into it.
+  static absl::StatusOr<UntypedMessage> ParseFromStream(
+      const ResolverPool::Message* desc, io::CodedInputStream& stream) {
+    UntypedMessage msg(std::move(desc));
+    RETURN_IF_ERROR(msg.Decode(stream));
+    return std::move(msg);
+  }
+
   absl::Status Decode(io::CodedInputStream& stream,
                       absl::optional<int32_t> current_group = absl::nullopt);
 
@@ -105,17 +105,19 @@ class JsonWriter {
 
   void Write(char c) { sink_.Append(&c, 1); }
 
-  // The precision on this and the following function are completely made-up,
-  // in an attempt to match the behavior of the ESF parser.
+  // Floating point values are written with the shortest digits that parse
+  // back to the same value; see io::DoubleToBuffer().
   void Write(double val) {
     if (!MaybeWriteSpecialFp(val)) {
-      Write(io::SimpleDtoa(val));
+      char buf[io::kDoubleToBufferSize];
+      Write(absl::string_view(buf, io::DoubleToBuffer(val, buf)));
     }
   }
 
   void Write(float val) {
     if (!MaybeWriteSpecialFp(val)) {
-      Write(io::SimpleFtoa(val));
+      char buf[io::kFloatToBufferSize];
+      Write(absl::string_view(buf, io::FloatToBuffer(val, buf)));
     }
   }
 
@@ -8,9 +8,11 @@
 #include "google/protobuf/json/internal/zero_copy_buffered_stream.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/strings/str_format.h"
@@ -23,6 +25,38 @@
 namespace google {
 namespace protobuf {
 namespace json_internal {
+namespace {
+// Buffers that grew past this size are released instead of being kept for
+// reuse, so that one large input does not pin memory to the thread.
+constexpr size_t kMaxRetainedBufferSize = 1 << 20;
+
+std::vector<char>& ThreadBuffer() {
+  thread_local std::vector<char> buffer;
+  return buffer;
+}
+}  // namespace
+
+ZeroCopyBufferedStream::ZeroCopyBufferedStream(io::ZeroCopyInputStream* stream,
+                                               bool reuse_thread_buffer)
+    : stream_(stream), reuse_thread_buffer_(reuse_thread_buffer) {
+  // A nested parse on the same thread finds the buffer already borrowed and
+  // starts from an empty one.
+  if (reuse_thread_buffer_) {
+    buf_.swap(ThreadBuffer());
+  }
+}
+
+ZeroCopyBufferedStream::~ZeroCopyBufferedStream() {
+  if (!reuse_thread_buffer_ || buf_.capacity() > kMaxRetainedBufferSize) {
+    return;
+  }
+  std::vector<char>& thread_buffer = ThreadBuffer();
+  if (buf_.capacity() > thread_buffer.capacity()) {
+    buf_.clear();
+    buf_.swap(thread_buffer);
+  }
+}
+
 absl::Status ZeroCopyBufferedStream::Advance(size_t bytes) {
   while (bytes != 0) {
     if (Unread().empty() && !ReadChunk()) {
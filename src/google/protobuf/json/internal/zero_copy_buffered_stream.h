@@ -9,7 +9,9 @@
 #define GOOGLE_PROTOBUF_JSON_INTERNAL_ZERO_COPY_BUFFERED_STREAM_H__
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -21,6 +23,8 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/stubs/status_macros.h"
 
@@ -67,12 +71,18 @@ class MaybeOwnedString {
   MaybeOwnedString(ZeroCopyBufferedStream* stream, size_t start, size_t len,
                    BufferingGuard token)
       : data_(StreamOwned{stream, start, len}), token_(token) {}
+  // Copies `value` onto `arena`, which must outlive this string.
+  MaybeOwnedString(absl::string_view value, Arena* arena)
+      : data_(ArenaOwned::Copy(value, arena)) {}
 
   // Returns the string as a view, regardless of whether it is owned or not.
   absl::string_view AsView() const {
     if (auto* unowned = absl::get_if<StreamOwned>(&data_)) {
       return unowned->AsView();
     }
+    if (auto* on_arena = absl::get_if<ArenaOwned>(&data_)) {
+      return absl::string_view(on_arena->data, on_arena->len);
+    }
 
     return absl::get<std::string>(data_);
   }
@@ -87,9 +97,43 @@ class MaybeOwnedString {
       token_ = BufferingGuard{};
     }
 
+    if (auto* on_arena = absl::get_if<ArenaOwned>(&data_)) {
+      data_ = std::string(on_arena->data, on_arena->len);
+    }
+
     return absl::get<std::string>(data_);
   }
 
+  // Returns a view that stays valid for as long as this string, even if the
+  // stream buffers more data. Stream-owned contents are copied first, onto
+  // `arena` if it is not null and into an owned string otherwise.
+  absl::string_view ToStableView(Arena* arena) {
+    Own(arena);
+    return AsView();
+  }
+
+  // Like ToStableView(), but returns the contents as mutable.
+  absl::Span<char> ToMutableSpan(Arena* arena) {
+    Own(arena);
+    if (auto* on_arena = absl::get_if<ArenaOwned>(&data_)) {
+      return absl::MakeSpan(on_arena->data, on_arena->len);
+    }
+    std::string& owned = absl::get<std::string>(data_);
+    return absl::MakeSpan(&owned[0], owned.size());
+  }
+
+  // Drops all but the first `len` bytes.
+  void Truncate(size_t len) {
+    if (auto* unowned = absl::get_if<StreamOwned>(&data_)) {
+      unowned->len = std::min(unowned->len, len);
+    } else if (auto* on_arena = absl::get_if<ArenaOwned>(&data_)) {
+      on_arena->len = std::min(on_arena->len, len);
+    } else {
+      std::string& owned = absl::get<std::string>(data_);
+      owned.resize(std::min(owned.size(), len));
+    }
+  }
+
   template <typename String>
   friend bool operator==(const MaybeOwnedString& lhs, const String& rhs) {
     return lhs.AsView() == rhs;
@@ -105,7 +149,29 @@ class MaybeOwnedString {
     size_t start, len;
     absl::string_view AsView() const;
   };
-  absl::variant<std::string, StreamOwned> data_;
+  struct ArenaOwned {
+    static ArenaOwned Copy(absl::string_view value, Arena* arena) {
+      char* data = Arena::CreateArray<char>(arena, value.size());
+      if (!value.empty()) memcpy(data, value.data(), value.size());
+      return {data, value.size()};
+    }
+    char* data;
+    size_t len;
+  };
+
+  // Copies stream-owned contents so that they no longer refer to the stream.
+  void Own(Arena* arena) {
+    auto* unowned = absl::get_if<StreamOwned>(&data_);
+    if (unowned == nullptr) return;
+    if (arena != nullptr) {
+      data_ = ArenaOwned::Copy(unowned->AsView(), arena);
+      token_ = BufferingGuard{};
+    } else {
+      ToString();
+    }
+  }
+
+  absl::variant<std::string, StreamOwned, ArenaOwned> data_;
   BufferingGuard token_;
 };
 
@@ -132,8 +198,16 @@ class Mark {
 // provide, while minimizing the amount of actual copying.
 class ZeroCopyBufferedStream {
  public:
-  explicit ZeroCopyBufferedStream(io::ZeroCopyInputStream* stream)
-      : stream_(stream) {}
+  // If `reuse_thread_buffer` is true, the buffer used for data straddling
+  // chunks of `stream` is borrowed from the current thread and handed back on
+  // destruction, so that repeated parses on the same thread reuse its
+  // capacity instead of reallocating it.
+  explicit ZeroCopyBufferedStream(io::ZeroCopyInputStream* stream,
+                                  bool reuse_thread_buffer = false);
+  ~ZeroCopyBufferedStream();
+
+  ZeroCopyBufferedStream(const ZeroCopyBufferedStream&) = delete;
+  ZeroCopyBufferedStream& operator=(const ZeroCopyBufferedStream&) = delete;
 
   // Returns whether the stream is currently at eof.
   //
@@ -255,6 +329,7 @@ class ZeroCopyBufferedStream {
   size_t buffer_start_ = 0;
   bool eof_ = false;
   int outstanding_buffer_borrows_ = 0;
+  bool reuse_thread_buffer_;
 };
 
 // These functions all rely on the definition of ZeroCopyBufferedStream, so must
@@ -291,10 +366,17 @@ absl::StatusOr<MaybeOwnedString> ZeroCopyBufferedStream::TakeWhile(Pred p) {
       // We treat EOF as ending the take, rather than being an error.
       break;
     }
-    if (!p(cursor_ - start, PeekChar())) {
+    // Run the predicate over everything that is already buffered, so that we
+    // advance once per chunk rather than once per character.
+    absl::string_view unread = Unread();
+    size_t n = 0;
+    while (n < unread.size() && p(cursor_ - start + n, unread[n])) {
+      ++n;
+    }
+    RETURN_IF_ERROR(Advance(n));
+    if (n < unread.size()) {
       break;
     }
-    RETURN_IF_ERROR(Advance(1));
   }
 
   return MaybeOwnedString(this, start, cursor_ - start, guard);
@@ -7,10 +7,15 @@
 
 #include "google/protobuf/json/json.h"
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/json/internal/parser.h"
 #include "google/protobuf/json/internal/unparser.h"
@@ -49,10 +54,21 @@ absl::Status BinaryToJsonString(google::protobuf::util::TypeResolver* resolver,
                                 const std::string& binary_input,
                                 std::string* json_output,
                                 const PrintOptions& options) {
-  io::ArrayInputStream input_stream(binary_input.data(), binary_input.size());
+  google::protobuf::json_internal::WriterOptions opts;
+  opts.add_whitespace = options.add_whitespace;
+  opts.preserve_proto_field_names = options.preserve_proto_field_names;
+  opts.always_print_enums_as_ints = options.always_print_enums_as_ints;
+  opts.always_print_fields_with_no_presence =
+      options.always_print_fields_with_no_presence;
+  opts.unquote_int64_if_possible = options.unquote_int64_if_possible;
+
+  // TODO: Drop this setting.
+  opts.allow_legacy_syntax = true;
+
+  // The input is already flat, so it can be transcoded in place.
   io::StringOutputStream output_stream(json_output);
-  return BinaryToJsonStream(resolver, type_url, &input_stream, &output_stream,
-                            options);
+  return google::protobuf::json_internal::BinaryToJsonStream(
+      resolver, type_url, binary_input, &output_stream, opts);
 }
 
 absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
@@ -63,6 +79,7 @@ absl::Status JsonToBinaryStream(google::protobuf::util::TypeResolver* resolver,
   google::protobuf::json_internal::ParseOptions opts;
   opts.ignore_unknown_fields = options.ignore_unknown_fields;
   opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
+  opts.arena = options.arena;
 
   // TODO: Drop this setting.
   opts.allow_legacy_syntax = true;
@@ -110,12 +127,57 @@ absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
   google::protobuf::json_internal::ParseOptions opts;
   opts.ignore_unknown_fields = options.ignore_unknown_fields;
   opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
+  opts.arena = options.arena;
 
   // TODO: Drop this setting.
   opts.allow_legacy_syntax = true;
 
   return google::protobuf::json_internal::JsonStreamToMessage(input, message, opts);
 }
+
+absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    absl::FunctionRef<absl::Status(Message&)> callback,
+    const ParseOptions& options) {
+  google::protobuf::json_internal::ParseOptions opts;
+  opts.ignore_unknown_fields = options.ignore_unknown_fields;
+  opts.case_insensitive_enum_parsing = options.case_insensitive_enum_parsing;
+
+  // TODO: Drop this setting.
+  opts.allow_legacy_syntax = true;
+
+  return google::protobuf::json_internal::JsonStreamToMessages(input, prototype,
+                                                     callback, opts);
+}
+
+absl::Status JsonStreamToDelimitedStream(io::ZeroCopyInputStream* input,
+                                         const Message& prototype,
+                                         io::ZeroCopyOutputStream* output,
+                                         const ParseOptions& options) {
+  io::CodedOutputStream coded_output(output);
+  absl::Status status = JsonStreamToMessages(
+      input, prototype,
+      [&](Message& message) {
+        size_t size = message.ByteSizeLong();
+        if (size > INT_MAX) {
+          return absl::InvalidArgumentError(
+              "record is too large to be serialized");
+        }
+        coded_output.WriteVarint32(static_cast<uint32_t>(size));
+        message.SerializeWithCachedSizes(&coded_output);
+        if (coded_output.HadError()) {
+          return absl::InternalError("failed to write record");
+        }
+        return absl::OkStatus();
+      },
+      options);
+  // Writing the buffered tail of the output can fail too.
+  coded_output.Trim();
+  if (status.ok() && coded_output.HadError()) {
+    return absl::InternalError("failed to write output");
+  }
+  return status;
+}
 }  // namespace json
 }  // namespace protobuf
 }  // namespace google
@@ -12,8 +12,10 @@
 
 #include <string>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/util/type_resolver.h"
 
@@ -33,6 +35,15 @@ struct ParseOptions {
   // this option. If your enum needs to support different casing, consider using
   // allow_alias instead.
   bool case_insensitive_enum_parsing = false;
+
+  // If set, temporary strings created while parsing (keys and values that
+  // contain escapes or straddle chunks of the input stream) are allocated on
+  // this arena instead of the heap, and the parser's scratch buffers are
+  // reused across calls on the same thread. google.protobuf.Any payloads are
+  // built on the arena of the message being parsed. Parsing into a message
+  // allocated on this arena, and resetting it between inputs, keeps JSON
+  // parsing off the heap in steady state.
+  Arena* arena = nullptr;
 };
 
 struct PrintOptions {
@@ -98,6 +109,41 @@ inline absl::Status JsonStreamToMessage(io::ZeroCopyInputStream* input,
   return JsonStreamToMessage(input, message, ParseOptions());
 }
 
+// Parses a stream of JSON records of the type of `prototype`, calling
+// `callback` with each parsed message in turn. The input is either a single
+// top-level JSON array of records, or a sequence of records separated by
+// whitespace, such as newline-delimited JSON. An empty input has no records.
+//
+// Records are parsed one at a time into messages allocated on an arena that is
+// reset between records, so memory use is bounded by the largest record rather
+// than by the whole input. The temporary strings of the parser are allocated on
+// that arena too, so `options.arena` is not used. The message passed to
+// `callback` is only valid until it returns. Parsing stops at the first error
+// returned by `callback`, which is then returned.
+PROTOBUF_EXPORT absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    absl::FunctionRef<absl::Status(Message&)> callback,
+    const ParseOptions& options);
+
+inline absl::Status JsonStreamToMessages(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    absl::FunctionRef<absl::Status(Message&)> callback) {
+  return JsonStreamToMessages(input, prototype, callback, ParseOptions());
+}
+
+// Like JsonStreamToMessages(), but writes each record to `output` as a
+// length-delimited binary message, as read by
+// util::ParseDelimitedFromZeroCopyStream().
+PROTOBUF_EXPORT absl::Status JsonStreamToDelimitedStream(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    io::ZeroCopyOutputStream* output, const ParseOptions& options);
+
+inline absl::Status JsonStreamToDelimitedStream(
+    io::ZeroCopyInputStream* input, const Message& prototype,
+    io::ZeroCopyOutputStream* output) {
+  return JsonStreamToDelimitedStream(input, prototype, output, ParseOptions());
+}
+
 // Converts protobuf binary data to JSON.
 // The conversion will fail if:
 //   1. TypeResolver fails to resolve a type.
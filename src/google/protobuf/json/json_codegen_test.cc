@@ -0,0 +1,306 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Checks that the JSON writer generated with the json_codegen option produces
+// exactly what json::MessageToJsonString() produces.
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/json/json.h"
+#include "google/protobuf/json/json_codegen_unittest.pb.h"
+#include "google/protobuf/text_format.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace json {
+namespace {
+
+using ::protobuf_unittest::json_codegen::TestAllTypes;
+using ::protobuf_unittest::json_codegen::TestEmpty;
+using ::protobuf_unittest::json_codegen::TestEnum;
+
+constexpr float kFloatNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kFloatInf = std::numeric_limits<float>::infinity();
+constexpr double kDoubleNaN = std::numeric_limits<double>::quiet_NaN();
+constexpr double kDoubleInf = std::numeric_limits<double>::infinity();
+
+// A string exercising the escapes of the JSON writer.
+std::string EscapedString() {
+  return absl::StrCat("quote\" backslash\\ <tag> & 'x'\t\n",
+                      absl::string_view("\0\x01\x1f\x7f", 4),
+                      "\xc3\xa9\xe2\x80\xa8\xf0\x9f\x98\x80");
+}
+
+std::string AllBytes() {
+  std::string bytes;
+  for (int i = 0; i < 256; ++i) bytes.push_back(static_cast<char>(i));
+  return bytes;
+}
+
+template <typename T>
+void ExpectSameJson(const T& message) {
+  std::string expected;
+  ASSERT_TRUE(MessageToJsonString(message, &expected).ok());
+  std::string actual;
+  ASSERT_TRUE(message.SerializeToJson(&actual).ok());
+  EXPECT_EQ(actual, expected);
+
+  // The output is appended.
+  std::string appended = "prefix";
+  ASSERT_TRUE(message.SerializeToJson(&appended).ok());
+  EXPECT_EQ(appended, "prefix" + expected);
+}
+
+TEST(JsonCodegenTest, Empty) {
+  ExpectSameJson(TestEmpty());
+  ExpectSameJson(TestAllTypes());
+
+  std::string json;
+  ASSERT_TRUE(TestAllTypes().SerializeToJson(&json).ok());
+  EXPECT_EQ(json, "{}");
+}
+
+TEST(JsonCodegenTest, ImplicitPresence) {
+  TestAllTypes message;
+  // Zero values are omitted.
+  message.set_optional_int32(0);
+  message.set_optional_string("");
+  message.set_optional_enum(protobuf_unittest::json_codegen::FOO);
+  message.set_optional_double(0.0);
+  ExpectSameJson(message);
+
+  // Negative zero is not.
+  message.set_optional_float(-0.0f);
+  message.set_optional_double(-0.0);
+  ExpectSameJson(message);
+
+  message.Clear();
+  message.mutable_optional_message();
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Scalars) {
+  TestAllTypes message;
+  message.set_optional_int32(std::numeric_limits<int32_t>::min());
+  message.set_optional_int64(std::numeric_limits<int64_t>::min());
+  message.set_optional_uint32(std::numeric_limits<uint32_t>::max());
+  message.set_optional_uint64(std::numeric_limits<uint64_t>::max());
+  message.set_optional_sint32(-1);
+  message.set_optional_sint64(std::numeric_limits<int64_t>::max());
+  message.set_optional_fixed32(42);
+  message.set_optional_fixed64(uint64_t{1} << 53);
+  message.set_optional_sfixed32(-42);
+  message.set_optional_sfixed64(-(int64_t{1} << 53));
+  message.set_optional_float(0.1f);
+  message.set_optional_double(1e300);
+  message.set_optional_bool(true);
+  message.set_optional_string(EscapedString());
+  message.set_optional_bytes(AllBytes());
+  message.set_optional_enum(protobuf_unittest::json_codegen::BAZ);
+  message.mutable_optional_message()->set_value(7);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, ExplicitPresence) {
+  TestAllTypes message;
+  // Zero values are written when set.
+  message.set_explicit_int32(0);
+  message.set_explicit_float(0.0f);
+  message.set_explicit_bool(false);
+  message.set_explicit_string("");
+  message.set_explicit_enum(protobuf_unittest::json_codegen::FOO);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Floats) {
+  TestAllTypes message;
+  message.set_optional_float(kFloatNaN);
+  message.set_optional_double(-kDoubleInf);
+  message.set_explicit_float(kFloatInf);
+  for (float value : {kFloatNaN, kFloatInf, -kFloatInf, 1.5f, -0.0f,
+                      std::numeric_limits<float>::max(),
+                      std::numeric_limits<float>::denorm_min()}) {
+    message.add_repeated_float(value);
+  }
+  for (double value : {kDoubleNaN, kDoubleInf, -kDoubleInf, 0.1, 1e-300,
+                       std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::lowest()}) {
+    message.add_repeated_double(value);
+  }
+  (*message.mutable_map_sint32_float())[-1] = kFloatNaN;
+  (*message.mutable_map_sint32_float())[1] = 3.25f;
+  (*message.mutable_map_fixed64_double())[1] = kDoubleNaN;
+  (*message.mutable_map_fixed64_double())[2] = -kDoubleInf;
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Enums) {
+  TestAllTypes message;
+  message.set_optional_enum(protobuf_unittest::json_codegen::BAR);
+  message.add_repeated_enum(protobuf_unittest::json_codegen::FOO);
+  message.add_repeated_enum(protobuf_unittest::json_codegen::BAZ);
+  (*message.mutable_map_string_enum())["a"] =
+      protobuf_unittest::json_codegen::BAR;
+  ExpectSameJson(message);
+
+  // Values without a name are written as numbers.
+  message.set_optional_enum(static_cast<TestEnum>(42));
+  message.set_explicit_enum(static_cast<TestEnum>(-1));
+  message.add_repeated_enum(static_cast<TestEnum>(7));
+  (*message.mutable_map_string_enum())["b"] = static_cast<TestEnum>(8);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Repeated) {
+  TestAllTypes message;
+  message.add_repeated_int32(-1);
+  message.add_repeated_int32(0);
+  message.add_repeated_int32(1);
+  message.add_repeated_int64(std::numeric_limits<int64_t>::min());
+  message.add_repeated_uint64(std::numeric_limits<uint64_t>::max());
+  message.add_repeated_bool(true);
+  message.add_repeated_bool(false);
+  message.add_repeated_string(EscapedString());
+  message.add_repeated_string("");
+  message.add_repeated_bytes(AllBytes());
+  message.add_repeated_bytes("");
+  message.add_repeated_message()->set_value(1);
+  message.add_repeated_message();
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Oneof) {
+  TestAllTypes message;
+  message.set_oneof_uint32(0);
+  ExpectSameJson(message);
+  message.mutable_oneof_message();
+  ExpectSameJson(message);
+  message.mutable_oneof_message()->set_value(3);
+  ExpectSameJson(message);
+  message.set_oneof_string("");
+  ExpectSameJson(message);
+  message.set_oneof_string(EscapedString());
+  ExpectSameJson(message);
+  message.set_oneof_bytes(AllBytes());
+  ExpectSameJson(message);
+  message.set_oneof_enum(protobuf_unittest::json_codegen::FOO);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Maps) {
+  TestAllTypes message;
+  (*message.mutable_map_int32_int32())[-1] = 1;
+  (*message.mutable_map_int32_int32())[0] = 0;
+  (*message.mutable_map_int32_int32())[2] = -2;
+  (*message.mutable_map_int64_int64())[std::numeric_limits<int64_t>::min()] =
+      std::numeric_limits<int64_t>::max();
+  (*message.mutable_map_uint32_uint32())[std::numeric_limits<uint32_t>::max()] =
+      1;
+  (*message.mutable_map_uint64_uint64())[std::numeric_limits<uint64_t>::max()] =
+      2;
+  (*message.mutable_map_bool_bool())[true] = false;
+  (*message.mutable_map_bool_bool())[false] = true;
+  (*message.mutable_map_string_string())[""] = "";
+  (*message.mutable_map_string_string())[EscapedString()] = EscapedString();
+  (*message.mutable_map_string_string())["key"] = "value";
+  (*message.mutable_map_string_bytes())["bytes"] = AllBytes();
+  (*message.mutable_map_int32_message())[1].set_value(1);
+  (*message.mutable_map_int32_message())[2];
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, ParsedMaps) {
+  // The parsers fill maps through reflection, after which reflection iterates
+  // over the entries in the order they were parsed rather than in the order
+  // of the map.
+  std::string json = R"json({"mapInt32Int32":{)json";
+  for (int i = 0; i < 32; ++i) {
+    absl::StrAppend(&json, i > 0 ? "," : "", "\"", (i * 7919) % 101, "\":", i);
+  }
+  absl::StrAppend(
+      &json, R"json(},"mapStringString":{"z":"1","a":"2","m":"3"},)json",
+      R"json("mapInt32Message":{"3":{"value":3},"1":{"value":1},"2":{}}})json");
+  TestAllTypes message;
+  ASSERT_TRUE(JsonStringToMessage(json, &message).ok());
+  ASSERT_EQ(message.map_int32_int32_size(), 32);
+  ExpectSameJson(message);
+
+  message.Clear();
+  std::string text;
+  for (int i = 0; i < 32; ++i) {
+    absl::StrAppend(&text, "map_uint64_uint64 { key: ", (i * 7919) % 101,
+                    " value: ", i, " }\n");
+    absl::StrAppend(&text, "map_string_enum { key: \"", i, "\" value: BAZ }\n");
+  }
+  ASSERT_TRUE(TextFormat::ParseFromString(text, &message));
+  ASSERT_EQ(message.map_uint64_uint64_size(), 32);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, Nested) {
+  TestAllTypes message;
+  message.mutable_optional_timestamp()->set_seconds(1);
+  message.mutable_optional_timestamp()->set_nanos(500000000);
+  message.add_repeated_timestamp();
+  message.add_repeated_timestamp()->set_seconds(-1);
+  message.mutable_recursive()->set_optional_string("inner");
+  message.mutable_recursive()->mutable_recursive()->add_repeated_int32(1);
+  message.mutable_recursive()->mutable_recursive()->set_fieldname8(8);
+  ExpectSameJson(message);
+}
+
+TEST(JsonCodegenTest, FieldNames) {
+  TestAllTypes message;
+  message.set_fieldname1(1);
+  message.set_field_name2(2);
+  message.set__field_name3(3);
+  message.set_field__name4_(4);
+  message.set_field0name5(5);
+  message.set_field_0_name6(6);
+  message.set_fieldname7(7);
+  message.set_fieldname8(8);
+  message.set_field_name9(9);
+  message.set_field_name10(10);
+  message.set_field_name11(11);
+  message.set_field_name12(12);
+  message.set___field_name13(13);
+  message.set___field_name14(14);
+  message.set_field__name15(15);
+  message.set_field__name16(16);
+  message.set_field_name17__(17);
+  message.set_field_name18__(18);
+  message.set_foo_bar(19);
+  message.set_with_json_name(20);
+  message.set_pascal_with_json_name(21);
+  message.set_escaped_json_name(22);
+  ExpectSameJson(message);
+
+  // The capital of PascalCase names is restored on their camel case name.
+  std::string json;
+  ASSERT_TRUE(message.SerializeToJson(&json).ok());
+  EXPECT_NE(json.find("\"FieldName8\":8"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"Foo_bar\":19"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"customName\":20"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"Pascal_with_json_name\":21"), std::string::npos)
+      << json;
+}
+
+}  // namespace
+}  // namespace json
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
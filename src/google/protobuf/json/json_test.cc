@@ -23,9 +23,11 @@
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor_database.h"
 #include "google/protobuf/dynamic_message.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/test_zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl_lite.h"
@@ -444,7 +446,7 @@ TEST_P(JsonTest, FloatPrecision) {
   v.mutable_list_value()->add_values()->set_number_value(0.8799999952316284);
 
   EXPECT_THAT(ToJson(v),
-              IsOkAndHolds("[0.99000000953674316,0.87999999523162842]"));
+              IsOkAndHolds("[0.9900000095367432,0.8799999952316284]"));
 }
 
 TEST_P(JsonTest, FloatMinMaxValue) {
@@ -1316,6 +1318,194 @@ TEST(JsonErrorTest, FieldNameAndSyntaxErrorInSeparateChunks) {
                     "*@ *bool_value"));
 }
 
+TEST(JsonBinaryTest, StringsSplitAcrossChunks) {
+  std::unique_ptr<TypeResolver> resolver{
+      google::protobuf::util::NewTypeResolverForDescriptorPool(
+          "type.googleapis.com", DescriptorPool::generated_pool())};
+  TestMessage m;
+  m.set_string_value("hello world");
+  m.set_bytes_value("\x01\x02");
+  m.add_repeated_string_value("a");
+  m.add_repeated_string_value("");
+  m.mutable_message_value()->set_value(5);
+  std::string binary = m.SerializeAsString();
+
+  std::vector<std::string> chunks;
+  for (char c : binary) chunks.push_back(std::string(1, c));
+  io::internal::TestZeroCopyInputStream input_stream(chunks);
+  std::string json;
+  {
+    io::StringOutputStream output_stream(&json);
+    ASSERT_OK(BinaryToJsonStream(resolver.get(),
+                                 "type.googleapis.com/proto3.TestMessage",
+                                 &input_stream, &output_stream));
+  }
+  EXPECT_EQ(json,
+            R"({"stringValue":"hello world","bytesValue":"AQI=",)"
+            R"("messageValue":{"value":5},"repeatedStringValue":["a",""]})");
+
+  std::string truncated;
+  EXPECT_THAT(BinaryToJsonString(resolver.get(),
+                                 "type.googleapis.com/proto3.TestMessage",
+                                 binary.substr(0, 5), &truncated),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(JsonArenaTest, ParseWithArena) {
+  Arena arena;
+  ParseOptions options;
+  options.arena = &arena;
+
+  // One-character chunks make every key and value straddle chunks, and the
+  // second parse reuses the per-thread buffers of the first.
+  std::string json = R"json({
+    "stringValue": "esc\"aped\u00e9",
+    "bytesValue": "AQI=",
+    "repeatedStringValue": ["a", ""],
+    "messageValue": {"value": 5}
+  })json";
+  std::vector<std::string> chunks;
+  for (char c : json) chunks.push_back(std::string(1, c));
+  for (int i = 0; i < 2; ++i) {
+    io::internal::TestZeroCopyInputStream input_stream(chunks);
+    auto* m = Arena::Create<TestMessage>(&arena);
+    ASSERT_OK(JsonStreamToMessage(&input_stream, m, options));
+    EXPECT_EQ(m->string_value(), "esc\"aped\xc3\xa9");
+    EXPECT_EQ(m->bytes_value(), "\x01\x02");
+    EXPECT_THAT(m->repeated_string_value(), ElementsAre("a", ""));
+    EXPECT_EQ(m->message_value().value(), 5);
+  }
+
+  auto* any = Arena::Create<TestAny>(&arena);
+  ASSERT_OK(JsonStringToMessage(
+      R"json({"value": {"@type": "type.googleapis.com/proto3.TestMessage",
+                        "stringValue": "x\ty"}})json",
+      any, options));
+  TestMessage payload;
+  ASSERT_TRUE(any->value().UnpackTo(&payload));
+  EXPECT_EQ(payload.string_value(), "x\ty");
+
+  auto* map = Arena::Create<TestMap>(&arena);
+  ASSERT_OK(JsonStringToMessage(R"json({"stringMap": {"k\"ey": 1}})json",
+                                map, options));
+  EXPECT_EQ(map->string_map().at("k\"ey"), 1);
+}
+
+absl::StatusOr<std::vector<std::string>> ParseRecords(
+    const std::vector<std::string>& chunks) {
+  io::internal::TestZeroCopyInputStream input_stream(chunks);
+  std::vector<std::string> values;
+  RETURN_IF_ERROR(JsonStreamToMessages(
+      &input_stream, TestMessage::default_instance(), [&](Message& message) {
+        const auto& record = static_cast<const TestMessage&>(message);
+        values.push_back(absl::StrCat(record.int32_value(), ":",
+                                      record.string_value()));
+        return absl::OkStatus();
+      }));
+  return values;
+}
+
+TEST(JsonStreamTest, Array) {
+  EXPECT_THAT(ParseRecords({R"([{"int32Value": 1, "stringValue": "a"},)",
+                            R"( {"int32Value")", R"(: 2}, {})", "]\n"}),
+              IsOkAndHolds(ElementsAre("1:a", "2:", "0:")));
+  EXPECT_THAT(ParseRecords({" [ ] "}), IsOkAndHolds(IsEmpty()));
+}
+
+TEST(JsonStreamTest, NewlineDelimited) {
+  EXPECT_THAT(ParseRecords({R"({"int32Value": 1})", "\n", R"({"stringVa)",
+                            R"(lue": "b"})", "\n\n", R"({"int32Value": 3})"}),
+              IsOkAndHolds(ElementsAre("1:", "0:b", "3:")));
+  EXPECT_THAT(ParseRecords({}), IsOkAndHolds(IsEmpty()));
+  EXPECT_THAT(ParseRecords({"\n  \n"}), IsOkAndHolds(IsEmpty()));
+}
+
+TEST(JsonStreamTest, Errors) {
+  EXPECT_THAT(ParseRecords({R"([{"int32Value": 1}] {})"}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseRecords({R"({"int32Value": 1} {"int32Value": "x"})"}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParseRecords({R"([{"int32Value": 1})"}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  io::ArrayInputStream input_stream("{} {} {}", 8);
+  int count = 0;
+  absl::Status s = JsonStreamToMessages(
+      &input_stream, TestMessage::default_instance(), [&](Message&) {
+        return ++count == 2 ? absl::CancelledError("stop") : absl::OkStatus();
+      });
+  EXPECT_THAT(s, StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_EQ(count, 2);
+}
+
+TEST(JsonStreamTest, CallerArenaStaysFlat) {
+  // Escaped keys and values, and values that straddle chunks of the input,
+  // are copied onto an arena. The stream puts them on the arena of each record
+  // rather than on ParseOptions::arena, which it never resets.
+  std::string json;
+  for (int i = 0; i < 1000; ++i) {
+    absl::StrAppend(&json, R"({"int32\u0056alue": )", i,
+                    R"(, "stringValue": "record \")", i, R"(\"\n"})", "\n");
+  }
+  io::ArrayInputStream input_stream(json.data(), json.size(),
+                                    /*block_size=*/7);
+  Arena arena;
+  ParseOptions options;
+  options.arena = &arena;
+  const uint64_t space_used = arena.SpaceUsed();
+
+  int count = 0;
+  ASSERT_OK(JsonStreamToMessages(
+      &input_stream, TestMessage::default_instance(),
+      [&](Message& message) {
+        const auto& record = static_cast<const TestMessage&>(message);
+        EXPECT_EQ(record.int32_value(), count);
+        EXPECT_EQ(record.string_value(),
+                  absl::StrCat("record \"", count, "\"\n"));
+        ++count;
+        return absl::OkStatus();
+      },
+      options));
+  EXPECT_EQ(count, 1000);
+  EXPECT_EQ(arena.SpaceUsed(), space_used);
+}
+
+TEST(JsonStreamTest, Delimited) {
+  std::string json = R"([{"int32Value": 1}, {"stringValue": "foo"}])";
+  io::ArrayInputStream input_stream(json.data(), json.size());
+  std::string binary;
+  {
+    io::StringOutputStream output_stream(&binary);
+    ASSERT_OK(JsonStreamToDelimitedStream(
+        &input_stream, TestMessage::default_instance(), &output_stream));
+  }
+
+  io::CodedInputStream coded_input(
+      reinterpret_cast<const uint8_t*>(binary.data()), binary.size());
+  std::vector<std::string> values;
+  uint32_t size;
+  while (coded_input.ReadVarint32(&size)) {
+    auto limit = coded_input.PushLimit(size);
+    TestMessage record;
+    ASSERT_TRUE(record.ParseFromCodedStream(&coded_input));
+    coded_input.PopLimit(limit);
+    values.push_back(
+        absl::StrCat(record.int32_value(), ":", record.string_value()));
+  }
+  EXPECT_THAT(values, ElementsAre("1:", "0:foo"));
+}
+
+TEST(JsonStreamTest, DelimitedOutputTooSmall) {
+  std::string json = R"({"stringValue": "foo"} {"stringValue": "bar"})";
+  io::ArrayInputStream input_stream(json.data(), json.size());
+  char buffer[8];
+  io::ArrayOutputStream output_stream(buffer, sizeof(buffer));
+  EXPECT_THAT(JsonStreamToDelimitedStream(
+                  &input_stream, TestMessage::default_instance(),
+                  &output_stream),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
 }  // namespace
 }  // namespace json
 }  // namespace protobuf
@@ -92,6 +92,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
@@ -103,6 +104,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "google/protobuf/arena.h"
+#include "google/protobuf/arenastring.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/generated_message_reflection.h"
 #include "google/protobuf/generated_message_tctable_decl.h"
@@ -137,6 +139,8 @@ class MapValueRef;
 class MapIterator;
 class MapReflectionTester;
 class TextFormat;
+template <typename T>
+class FieldAccessor;
 
 namespace internal {
 struct FuzzPeer;
@@ -186,6 +190,7 @@ PROTOBUF_EXPORT std::string Utf8Format(
     const Message& message);  // text_format.cc
 namespace util {
 class MessageDifferencer;
+class MessageHasher;
 }
 
 
@@ -414,6 +419,19 @@ void* CreateSplitMessageGeneric(Arena* arena, const void* default_split,
 // Forward-declare interfaces used to implement RepeatedFieldRef.
 // These are protobuf internals that users shouldn't care about.
 class RepeatedFieldAccessor;
+
+// Where a singular field lives, resolved once by Reflection::MakeAccessor().
+// When `direct_get` is set the value is stored at `offset` from the start of
+// the message; `direct_set` additionally means a store needs no validation.
+struct FieldAccessPlan {
+  const Reflection* reflection;
+  const FieldDescriptor* field;
+  uint32_t offset;
+  uint32_t has_bits_offset;
+  uint32_t has_bit_index;  // static_cast<uint32_t>(-1) if there is no hasbit.
+  bool direct_get;
+  bool direct_set;
+};
 }  // namespace internal
 
 // This interface contains methods that can be used to dynamically access
@@ -891,6 +909,22 @@ class PROTOBUF_EXPORT Reflection final {
   MutableRepeatedFieldRef<T> GetMutableRepeatedFieldRef(
       Message* message, const FieldDescriptor* field) const;
 
+  // Get a FieldAccessor that reads and writes a singular field of messages of
+  // this type.  The checks that the Get*() and Set*() methods above repeat on
+  // every call (extension, oneof, split and inlined string layout, hasbit
+  // position) are done once here, so for fields stored inline in the message
+  // FieldAccessor::Get() is a load at a fixed offset and Set() a store plus a
+  // hasbit update.  Other fields fall back to the methods above.
+  //
+  // T must match field->cpp_type() as for GetRepeatedFieldRef(), except that
+  // enum fields use int32_t (with GetEnumValue() and SetEnumValue()
+  // semantics) and string fields stored as absl::Cord are not supported.
+  //
+  // The accessor may be used for as long as this Reflection is alive, but only
+  // with messages for which GetReflection() returns this object.
+  template <typename T>
+  FieldAccessor<T> MakeAccessor(const FieldDescriptor* field) const;
+
   // DEPRECATED. Please use Get(Mutable)RepeatedFieldRef() for repeated field
   // access. The following repeated field accessors will be removed in the
   // future.
@@ -1096,6 +1130,8 @@ class PROTOBUF_EXPORT Reflection final {
   friend class RepeatedFieldRef;
   template <typename T, typename Enable>
   friend class MutableRepeatedFieldRef;
+  template <typename T>
+  friend class FieldAccessor;
   friend class Message;
   friend class MessageLayoutInspector;
   friend class AssignDescriptorsHelper;
@@ -1104,6 +1140,7 @@ class PROTOBUF_EXPORT Reflection final {
   friend class python::MapReflectionFriend;
   friend class python::MessageReflectionFriend;
   friend class util::MessageDifferencer;
+  friend class util::MessageHasher;
 #define GOOGLE_PROTOBUF_HAS_CEL_MAP_REFLECTION_FRIEND
   friend class expr::CelMapReflectionFriend;
   friend class internal::MapFieldReflectionTest;
@@ -1234,6 +1271,10 @@ class PROTOBUF_EXPORT Reflection final {
     return schema_.IsFieldInlined(field);
   }
 
+  // Used by MakeAccessor().  `cpp_type` is the type the accessor reads.
+  internal::FieldAccessPlan MakeFieldAccessPlan(
+      const FieldDescriptor* field, FieldDescriptor::CppType cpp_type) const;
+
   // Returns true if the field is considered to be present.
   // Requires the input to be 'singular' i.e. non-extension, non-oneof, non-weak
   // field.
@@ -1348,6 +1389,165 @@ class PROTOBUF_EXPORT Reflection final {
                                              internal::ParseContext* ctx);
 };
 
+namespace internal {
+
+// The parts of FieldAccessor<T> that do not depend on T.
+class FieldAccessorBase {
+ public:
+  const FieldDescriptor* field() const { return plan_.field; }
+
+  // Same as Reflection::HasField().
+  bool Has(const Message& message) const {
+    ABSL_DCHECK_EQ(message.GetReflection(), plan_.reflection);
+    if (PROTOBUF_PREDICT_TRUE(plan_.direct_get &&
+                              plan_.has_bit_index != kNoHasBit)) {
+      const uint32_t* has_bits =
+          GetConstPointerAtOffset<uint32_t>(&message, plan_.has_bits_offset);
+      return (has_bits[plan_.has_bit_index / 32] >>
+              (plan_.has_bit_index % 32)) &
+             1;
+    }
+    return plan_.reflection->HasField(message, plan_.field);
+  }
+
+ protected:
+  static constexpr uint32_t kNoHasBit = static_cast<uint32_t>(-1);
+
+  explicit FieldAccessorBase(const FieldAccessPlan& plan) : plan_(plan) {}
+
+  void SetHasBit(Message* message) const {
+    if (plan_.has_bit_index == kNoHasBit) return;
+    GetPointerAtOffset<uint32_t>(message, plan_.has_bits_offset)
+        [plan_.has_bit_index / 32] |= static_cast<uint32_t>(1)
+                                      << (plan_.has_bit_index % 32);
+  }
+
+  FieldAccessPlan plan_;
+};
+
+// Maps the C++ type of a FieldAccessor to the reflection methods it falls
+// back to for fields that are not stored inline.
+template <typename T>
+struct FieldAccessorTraits;
+
+#define PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(TYPE, METHOD, CPPTYPE)          \
+  template <>                                                                \
+  struct FieldAccessorTraits<TYPE> {                                         \
+    static constexpr FieldDescriptor::CppType kCppType =                     \
+        FieldDescriptor::CPPTYPE_##CPPTYPE;                                  \
+    static TYPE Get(const FieldAccessPlan& plan, const Message& message) {   \
+      return plan.reflection->Get##METHOD(message, plan.field);              \
+    }                                                                        \
+    static void Set(const FieldAccessPlan& plan, Message* message,           \
+                    TYPE value) {                                            \
+      plan.reflection->Set##METHOD(message, plan.field, value);              \
+    }                                                                        \
+  };
+
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(int64_t, Int64, INT64)
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(uint32_t, UInt32, UINT32)
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(uint64_t, UInt64, UINT64)
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(float, Float, FLOAT)
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(double, Double, DOUBLE)
+PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS(bool, Bool, BOOL)
+
+#undef PROTOBUF_DEFINE_FIELD_ACCESSOR_TRAITS
+
+// int32_t accessors also serve enum fields.
+template <>
+struct FieldAccessorTraits<int32_t> {
+  static constexpr FieldDescriptor::CppType kCppType =
+      FieldDescriptor::CPPTYPE_INT32;
+  static int32_t Get(const FieldAccessPlan& plan, const Message& message) {
+    return plan.field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM
+               ? plan.reflection->GetEnumValue(message, plan.field)
+               : plan.reflection->GetInt32(message, plan.field);
+  }
+  static void Set(const FieldAccessPlan& plan, Message* message,
+                  int32_t value) {
+    if (plan.field->cpp_type() == FieldDescriptor::CPPTYPE_ENUM) {
+      plan.reflection->SetEnumValue(message, plan.field, value);
+    } else {
+      plan.reflection->SetInt32(message, plan.field, value);
+    }
+  }
+};
+
+template <>
+struct FieldAccessorTraits<std::string> {
+  static constexpr FieldDescriptor::CppType kCppType =
+      FieldDescriptor::CPPTYPE_STRING;
+};
+
+}  // namespace internal
+
+// Reads and writes one singular field of messages of a given type.  Obtained
+// from Reflection::MakeAccessor(); see there for the supported types.  This is
+// a small value type and is cheap to copy.
+template <typename T>
+class FieldAccessor : public internal::FieldAccessorBase {
+ public:
+  // Same as Reflection::GetInt32() and friends.
+  T Get(const Message& message) const {
+    ABSL_DCHECK_EQ(message.GetReflection(), plan_.reflection);
+    if (PROTOBUF_PREDICT_TRUE(plan_.direct_get)) {
+      return internal::GetConstRefAtOffset<T>(message, plan_.offset);
+    }
+    return internal::FieldAccessorTraits<T>::Get(plan_, message);
+  }
+
+  // Same as Reflection::SetInt32() and friends.
+  void Set(Message* message, T value) const {
+    ABSL_DCHECK_EQ(message->GetReflection(), plan_.reflection);
+    if (PROTOBUF_PREDICT_TRUE(plan_.direct_set)) {
+      *internal::GetPointerAtOffset<T>(message, plan_.offset) = value;
+      SetHasBit(message);
+      return;
+    }
+    internal::FieldAccessorTraits<T>::Set(plan_, message, value);
+  }
+
+ private:
+  friend class Reflection;
+  explicit FieldAccessor(const internal::FieldAccessPlan& plan)
+      : FieldAccessorBase(plan) {}
+};
+
+template <>
+class FieldAccessor<std::string> : public internal::FieldAccessorBase {
+ public:
+  // Same as Reflection::GetStringReference().
+  const std::string& Get(const Message& message) const {
+    ABSL_DCHECK_EQ(message.GetReflection(), plan_.reflection);
+    if (PROTOBUF_PREDICT_TRUE(plan_.direct_get)) {
+      const auto& str =
+          internal::GetConstRefAtOffset<internal::ArenaStringPtr>(
+              message, plan_.offset);
+      return str.IsDefault() ? plan_.field->default_value_string() : str.Get();
+    }
+    // Cord fields are rejected by MakeAccessor(), so no scratch is needed.
+    return plan_.reflection->GetStringReference(message, plan_.field, nullptr);
+  }
+
+  // Same as Reflection::SetString().
+  void Set(Message* message, std::string value) const {
+    ABSL_DCHECK_EQ(message->GetReflection(), plan_.reflection);
+    if (PROTOBUF_PREDICT_TRUE(plan_.direct_set)) {
+      internal::GetPointerAtOffset<internal::ArenaStringPtr>(message,
+                                                             plan_.offset)
+          ->Set(std::move(value), message->GetArena());
+      SetHasBit(message);
+      return;
+    }
+    plan_.reflection->SetString(message, plan_.field, std::move(value));
+  }
+
+ private:
+  friend class Reflection;
+  explicit FieldAccessor(const internal::FieldAccessPlan& plan)
+      : FieldAccessorBase(plan) {}
+};
+
 extern template void Reflection::SwapFieldsImpl<true>(
     Message* message1, Message* message2,
     const std::vector<const FieldDescriptor*>& fields) const;
@@ -1648,6 +1848,12 @@ MutableRepeatedFieldRef<T> Reflection::GetMutableRepeatedFieldRef(
   return MutableRepeatedFieldRef<T>(message, field);
 }
 
+template <typename T>
+FieldAccessor<T> Reflection::MakeAccessor(const FieldDescriptor* field) const {
+  return FieldAccessor<T>(
+      MakeFieldAccessPlan(field, internal::FieldAccessorTraits<T>::kCppType));
+}
+
 
 }  // namespace protobuf
 }  // namespace google
@@ -8,6 +8,8 @@
 #ifndef GOOGLE_PROTOBUF_PARSE_CONTEXT_H__
 #define GOOGLE_PROTOBUF_PARSE_CONTEXT_H__
 
+#include <algorithm>
+#include <climits>
 #include <cstdint>
 #include <cstring>
 #include <string>
@@ -229,6 +231,27 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
   PROTOBUF_NODISCARD const char* ReadPackedVarint(const char* ptr, Add add,
                                                   SizeCb size_callback);
 
+  // Capacity hints for repeated fields. Each function scans ahead of `ptr`
+  // without consuming anything and returns how many elements the parser is
+  // about to add, counting only what lies in the current buffer, including its
+  // slop region, and before the current limit. The result is a hint: malformed
+  // input is still detected by the actual parse.
+  //
+  // Number of varints in the packed payload whose length prefix is at `ptr`,
+  // or 0 if the payload is not entirely in the current buffer.
+  int CountPackedVarints(const char* ptr) const;
+  // Number of consecutive non-packed fields tagged `expected_tag` at `ptr`,
+  // where each value is `value_size` bytes long.
+  template <typename Tag>
+  int CountRepeatedFixed(const char* ptr, Tag expected_tag,
+                         int value_size) const;
+  // Number of consecutive non-packed varint fields tagged `expected_tag`.
+  template <typename Tag>
+  int CountRepeatedVarint(const char* ptr, Tag expected_tag) const;
+  // Number of consecutive length-delimited fields tagged `expected_tag`.
+  template <typename Tag>
+  int CountRepeatedLengthDelimited(const char* ptr, Tag expected_tag) const;
+
   uint32_t LastTag() const { return last_tag_minus_1_ + 1; }
   bool ConsumeEndGroup(uint32_t start_tag) {
     bool res = last_tag_minus_1_ == start_tag;
@@ -317,6 +340,13 @@ class PROTOBUF_EXPORT EpsCopyInputStream {
                 "the slop bytes from the previous buffer, plus the first "
                 "kSlopBytes from the next buffer.");
 
+  // End of the bytes the capacity hints may scan: the slop region after
+  // buffer_end_ is readable, and for flat input it holds the last bytes of the
+  // data, but nothing past the current limit belongs to the field.
+  const char* CountEnd() const {
+    return buffer_end_ + (std::min)(limit_, static_cast<int>(kSlopBytes));
+  }
+
   const char* limit_end_;  // buffer_end_ + min(limit_, 0)
   const char* buffer_end_;
   const char* next_chunk_;
@@ -1250,6 +1280,88 @@ const char* EpsCopyInputStream::ReadPackedVarint(const char* ptr, Add add,
   return end == ptr ? ptr : nullptr;
 }
 
+// Every varint ends in exactly one byte without the continuation bit, so the
+// number of such bytes is the number of varints in [ptr, end).
+inline int CountVarints(const char* ptr, const char* end) {
+  int count = 0;
+  for (; ptr < end; ++ptr) {
+    count += static_cast<uint8_t>(*ptr) < 0x80;
+  }
+  return count;
+}
+
+// Reads a length prefix that must lie entirely in [*ptr, end). Returns -1 if
+// it does not.
+inline int ReadBoundedSize(const char** ptr, const char* end) {
+  const char* p = *ptr;
+  uint32_t size = 0;
+  for (int shift = 0; shift < 35 && p < end; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*p++);
+    size |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      if (size > static_cast<uint32_t>(INT_MAX)) return -1;
+      *ptr = p;
+      return static_cast<int>(size);
+    }
+  }
+  return -1;
+}
+
+inline int EpsCopyInputStream::CountPackedVarints(const char* ptr) const {
+  int size = ReadSize(&ptr);
+  if (ptr == nullptr || size > CountEnd() - ptr) return 0;
+  return CountVarints(ptr, ptr + size);
+}
+
+// The scans below only count elements that end before CountEnd(), and never
+// read past it.
+template <typename Tag>
+int EpsCopyInputStream::CountRepeatedFixed(const char* ptr, Tag expected_tag,
+                                           int value_size) const {
+  const char* const end = CountEnd();
+  const int element_size = static_cast<int>(sizeof(Tag)) + value_size;
+  int count = 0;
+  while (end - ptr >= element_size &&
+         UnalignedLoad<Tag>(ptr) == expected_tag) {
+    ptr += element_size;
+    ++count;
+  }
+  return count;
+}
+
+template <typename Tag>
+int EpsCopyInputStream::CountRepeatedVarint(const char* ptr,
+                                            Tag expected_tag) const {
+  const char* const end = CountEnd();
+  int count = 0;
+  while (end - ptr > static_cast<int>(sizeof(Tag)) &&
+         UnalignedLoad<Tag>(ptr) == expected_tag) {
+    ptr += sizeof(Tag);
+    const char* const varint_end = ptr + (std::min)(10, static_cast<int>(end - ptr));
+    while (ptr < varint_end && static_cast<uint8_t>(*ptr) >= 0x80) ++ptr;
+    if (ptr == varint_end) break;
+    ++ptr;
+    ++count;
+  }
+  return count;
+}
+
+template <typename Tag>
+int EpsCopyInputStream::CountRepeatedLengthDelimited(const char* ptr,
+                                                     Tag expected_tag) const {
+  const char* const end = CountEnd();
+  int count = 0;
+  while (end - ptr > static_cast<int>(sizeof(Tag)) &&
+         UnalignedLoad<Tag>(ptr) == expected_tag) {
+    ptr += sizeof(Tag);
+    int size = ReadBoundedSize(&ptr, end);
+    if (size < 0 || size > end - ptr) break;
+    ptr += size;
+    ++count;
+  }
+  return count;
+}
+
 // Helper for verification of utf8
 PROTOBUF_EXPORT
 bool VerifyUTF8(absl::string_view s, const char* field_name);
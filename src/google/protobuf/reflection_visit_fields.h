@@ -1,11 +1,13 @@
 #ifndef GOOGLE_PROTOBUF_REFLECTION_VISIT_FIELDS_H__
 #define GOOGLE_PROTOBUF_REFLECTION_VISIT_FIELDS_H__
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/base/prefetch.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/cord.h"
 #include "google/protobuf/descriptor.h"
@@ -82,6 +84,17 @@ class ReflectionVisit final {
                                               Message& message) {
     return *reflection->MutableExtensionSet(&message);
   }
+
+  // How many fields ahead of the visit singular submessages are prefetched.
+  static constexpr int kPrefetchDistance = 8;
+
+  // Prefetches the present singular submessages among fields [*next, limit)
+  // and advances *next to limit.  Only fields with hasbits are considered.
+  template <typename MessageT>
+  static void PrefetchSubmessages(const Reflection* reflection,
+                                  const MessageT& message,
+                                  const uint32_t* has_bits, int* next,
+                                  int limit);
 };
 
 inline bool ShouldVisit(FieldMask mask, FieldDescriptor::CppType cpptype) {
@@ -97,17 +110,31 @@ void ReflectionVisit::VisitFields(MessageT& message, CallbackFn&& func,
 
   ABSL_CHECK(!schema.HasWeakFields()) << "weak fields are not supported";
 
+  // Optimization:  The default instance never has any fields set.
+  if (schema.IsDefaultInstance(message)) return;
+
   // See Reflection::ListFields for the optimization.
   const uint32_t* const has_bits =
       schema.HasHasbits() ? reflection->GetHasBits(message) : nullptr;
   const uint32_t* const has_bits_indices = schema.has_bit_indices_;
   const Descriptor* descriptor = GetDescriptor(reflection);
   const int field_count = descriptor->field_count();
+  // Singular submessages are prefetched a few fields ahead of the visit so
+  // that the callback does not stall on them when it recurses.
+  const bool prefetch =
+      has_bits != nullptr &&
+      ShouldVisit(mask, FieldDescriptor::CPPTYPE_MESSAGE);
+  int prefetched = 0;
 
   for (int i = 0; i < field_count; i++) {
     const FieldDescriptor* field = descriptor->field(i);
     ABSL_DCHECK(!field->options().weak()) << "weak fields are not supported";
 
+    if (prefetch) {
+      PrefetchSubmessages(reflection, message, has_bits, &prefetched,
+                          std::min(i + kPrefetchDistance, field_count));
+    }
+
     if (!ShouldVisit(mask, field->cpp_type())) continue;
 
     if (field->is_repeated()) {
@@ -411,6 +438,32 @@ void ReflectionVisit::VisitFields(MessageT& message, CallbackFn&& func,
       ExtensionSet::Prefetch{});
 }
 
+template <typename MessageT>
+void ReflectionVisit::PrefetchSubmessages(const Reflection* reflection,
+                                          const MessageT& message,
+                                          const uint32_t* has_bits, int* next,
+                                          int limit) {
+  const auto& schema = GetSchema(reflection);
+  const uint32_t* const has_bits_indices = schema.has_bit_indices_;
+  const Descriptor* descriptor = GetDescriptor(reflection);
+  for (int i = *next; i < limit; i++) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE ||
+        field->is_repeated() || schema.InRealOneof(field) ||
+        reflection->IsLazyField(field)) {
+      continue;
+    }
+    const uint32_t index = has_bits_indices[i];
+    if (index == static_cast<uint32_t>(-1) ||
+        (has_bits[index / 32] & (1u << (index % 32))) == 0) {
+      continue;
+    }
+    absl::PrefetchToLocalCache(
+        reflection->GetRawNonOneof<const Message*>(message, field));
+  }
+  *next = limit;
+}
+
 template <typename CallbackFn>
 void ReflectionVisit::VisitMessageFields(const Message& message,
                                          CallbackFn&& func) {
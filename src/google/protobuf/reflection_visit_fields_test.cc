@@ -453,6 +453,42 @@ TEST(ReflectionVisitTest, VisitMapAfterMutableRepeated) {
                                  testing::Pair(0, 200), testing::Pair(1, 200)));
 }
 
+TEST(ReflectionVisitTest, DefaultInstanceVisitsNothing) {
+  int count = 0;
+  VisitFields(TestAllTypes::default_instance(), [&](auto info) { ++count; });
+  VisitMessageFields(TestAllTypes::default_instance(),
+                     [&](const Message& msg) { ++count; });
+  EXPECT_EQ(count, 0);
+}
+
+TEST(ReflectionVisitTest, VisitsSubmessagesPastPrefetchWindow) {
+  // Message fields, including lazy ones, are spread over many more fields
+  // than the prefetch window.
+  TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+
+  std::vector<int> numbers;
+  VisitFields(
+      message,
+      [&](auto info) {
+        if constexpr (!info.is_repeated && !info.is_map) {
+          numbers.push_back(info.number());
+        }
+      },
+      FieldMask::kMessage);
+
+  std::vector<const FieldDescriptor*> fields;
+  message.GetReflection()->ListFields(message, &fields);
+  std::vector<int> expected;
+  for (const FieldDescriptor* field : fields) {
+    if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        !field->is_repeated()) {
+      expected.push_back(field->number());
+    }
+  }
+  EXPECT_THAT(numbers, testing::UnorderedElementsAreArray(expected));
+}
+
 #endif  // __cpp_if_constexpr
 
 }  // namespace
@@ -1207,6 +1207,14 @@ PROTOBUF_NOINLINE void RepeatedField<Element>::GrowNoAnnotate(bool was_soo,
     new_size = static_cast<int>(num_available);
     new_rep = static_cast<HeapRep*>(res.p);
   } else {
+    if (!was_soo &&
+        arena->TryExtendArrayInPlace(
+            heap_rep(), kHeapRepHeaderSize + sizeof(Element) * old_capacity,
+            bytes)) {
+      // The elements did not move, only the capacity changes.
+      soo_rep_.set_non_soo(was_soo, new_size, soo_rep_.long_rep.elements());
+      return;
+    }
     new_rep =
         reinterpret_cast<HeapRep*>(Arena::CreateArray<char>(arena, bytes));
   }
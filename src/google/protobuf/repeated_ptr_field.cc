@@ -61,6 +61,13 @@ void** RepeatedPtrFieldBase::InternalExtend(int extend_amount) {
       new_capacity = static_cast<int>((alloc.n - kRepHeaderSize) / kPtrSize);
       new_rep = reinterpret_cast<Rep*>(alloc.p);
     } else {
+      if (!using_sso() &&
+          arena->TryExtendArrayInPlace(
+              rep(), old_capacity * kPtrSize + kRepHeaderSize, new_size)) {
+        // The pointer array did not move, only the capacity changes.
+        capacity_proxy_ = new_capacity - kSSOCapacity;
+        return &rep()->elements[current_size_];
+      }
       auto* alloc = Arena::CreateArray<char>(arena, new_size);
       new_rep = reinterpret_cast<Rep*>(alloc);
     }
@@ -197,6 +197,20 @@ class PROTOBUF_EXPORT SerialArena {
     PROTOBUF_POISON_MEMORY_REGION(p, size);
   }
 
+  // Grows the array allocation at `p` from `old_size` to `new_size` bytes
+  // without moving it. This only succeeds when `p` is the most recent
+  // allocation of the current block and the block has room left, which is the
+  // common case for a repeated field that is built incrementally. Both sizes
+  // must be default aligned.
+  bool TryExtendArrayInPlace(void* p, size_t old_size, size_t new_size) {
+    ABSL_DCHECK(internal::ArenaAlignDefault::IsAligned(old_size));
+    ABSL_DCHECK(internal::ArenaAlignDefault::IsAligned(new_size));
+    ABSL_DCHECK_GE(new_size, old_size);
+    if (static_cast<char*>(p) + old_size != ptr()) return false;
+    void* unused;
+    return MaybeAllocateAligned(new_size - old_size, &unused);
+  }
+
  public:
   // Allocate space if the current region provides enough space.
   bool MaybeAllocateAligned(size_t n, void** out) {
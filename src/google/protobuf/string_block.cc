@@ -0,0 +1,137 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2023 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/string_block.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "absl/numeric/bits.h"
+#include "google/protobuf/port.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// Recycling blocks would hide use-after-free and uninitialized reads of string
+// blocks from the sanitizers, so they always go to the allocator directly.
+#if defined(PROTOBUF_ASAN) || defined(PROTOBUF_MSAN)
+
+void* StringBlock::AllocateHeapBlock(size_t size) {
+  return ::operator new(size);
+}
+
+void StringBlock::FreeHeapBlock(void* p, size_t size) {
+  internal::SizedDelete(p, size);
+}
+
+#else  // PROTOBUF_ASAN || PROTOBUF_MSAN
+
+namespace {
+
+// Free lists of the heap allocated string blocks released by the current
+// thread, one per block size. Blocks are sized in powers of two from 256B to
+// 8KB (before rounding down to a whole number of strings), so
+// `bit_width(size - 1)` identifies the size class. Each list is linked through
+// the first word of its blocks.
+//
+// The cache is trivially destructible so that it remains usable while other
+// thread-local and static objects are destroyed: once the blocks have been
+// released at thread exit, it is bypassed.
+struct ThreadBlockCache {
+  static constexpr size_t kMinSizeBits = 8;
+  static constexpr size_t kNumSizes = 6;
+  // Bounds the cache to about 126KB of idle memory per thread.
+  static constexpr uint8_t kMaxBlocksPerSize = 8;
+
+  enum State : uint8_t { kUnused, kActive, kReleased };
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static size_t Index(size_t size) {
+    return static_cast<size_t>(absl::bit_width(size - 1)) - kMinSizeBits;
+  }
+
+  FreeBlock* heads[kNumSizes];
+  uint8_t counts[kNumSizes];
+  State state;
+};
+
+#if defined(PROTOBUF_USE_DLLS) && defined(_WIN32)
+ThreadBlockCache& GetThreadBlockCache() {
+  static PROTOBUF_THREAD_LOCAL ThreadBlockCache thread_block_cache;
+  return thread_block_cache;
+}
+#else
+PROTOBUF_CONSTINIT PROTOBUF_THREAD_LOCAL ThreadBlockCache thread_block_cache;
+ThreadBlockCache& GetThreadBlockCache() { return thread_block_cache; }
+#endif
+
+// Frees the blocks cached by a thread when it exits.
+struct ThreadBlockCacheReleaser {
+  ~ThreadBlockCacheReleaser() {
+    ThreadBlockCache& cache = GetThreadBlockCache();
+    for (size_t i = 0; i < ThreadBlockCache::kNumSizes; ++i) {
+      while (ThreadBlockCache::FreeBlock* block = cache.heads[i]) {
+        cache.heads[i] = block->next;
+        ::operator delete(block);
+      }
+      cache.counts[i] = 0;
+    }
+    cache.state = ThreadBlockCache::kReleased;
+  }
+};
+
+}  // namespace
+
+void* StringBlock::AllocateHeapBlock(size_t size) {
+  ThreadBlockCache& cache = GetThreadBlockCache();
+  const size_t index = ThreadBlockCache::Index(size);
+  // A recycled block always has exactly the requested size: sizes are only
+  // ever produced by `RoundedSize()` of a power of two.
+  if (index < ThreadBlockCache::kNumSizes && cache.counts[index] > 0) {
+    ThreadBlockCache::FreeBlock* block = cache.heads[index];
+    cache.heads[index] = block->next;
+    --cache.counts[index];
+    return block;
+  }
+  return ::operator new(size);
+}
+
+void StringBlock::FreeHeapBlock(void* p, size_t size) {
+  ThreadBlockCache& cache = GetThreadBlockCache();
+  const size_t index = ThreadBlockCache::Index(size);
+  if (index < ThreadBlockCache::kNumSizes &&
+      cache.counts[index] < ThreadBlockCache::kMaxBlocksPerSize &&
+      cache.state != ThreadBlockCache::kReleased) {
+    if (cache.state == ThreadBlockCache::kUnused) {
+      // Registers the release of the cached blocks at thread exit.
+      static thread_local ThreadBlockCacheReleaser releaser;
+      (void)releaser;
+      cache.state = ThreadBlockCache::kActive;
+    }
+    cache.heads[index] =
+        new (p) ThreadBlockCache::FreeBlock{cache.heads[index]};
+    ++cache.counts[index];
+    return;
+  }
+  internal::SizedDelete(p, size);
+}
+
+#endif  // PROTOBUF_ASAN || PROTOBUF_MSAN
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -33,6 +33,10 @@ namespace internal {
 // StringBlocks are automatically sized from 256B to 8KB depending on the
 // `next` instance provided in the `New` function to keep the average maximum
 // unused space limited to 25%, or up to 4KB.
+// Heap allocated blocks are recycled through a small per-thread cache, so
+// that arenas which are repeatedly created and destroyed reuse the same blocks
+// instead of going through malloc for each of them. The cache is bypassed in
+// sanitizer builds.
 class alignas(std::string) StringBlock {
  public:
   StringBlock() = delete;
@@ -99,6 +103,11 @@ class alignas(std::string) StringBlock {
   static constexpr size_type min_size() { return size_type{256}; }
   static constexpr size_type max_size() { return size_type{8192}; }
 
+  // Allocates and frees the memory of heap allocated blocks, going through the
+  // per-thread block cache first.
+  PROTOBUF_EXPORT static void* AllocateHeapBlock(size_t size);
+  PROTOBUF_EXPORT static void FreeHeapBlock(void* p, size_t size);
+
   // Returns `size` rounded down such that we can fit a perfect number
   // of std::string instances inside a StringBlock of that size.
   static constexpr size_type RoundedSize(size_type size);
@@ -139,7 +148,7 @@ inline StringBlock* StringBlock::New(StringBlock* next) {
     next_size = std::min<size_type>(size * 2, max_size());
   }
   size = RoundedSize(size);
-  void* p = ::operator new(size);
+  void* p = AllocateHeapBlock(size);
   return new (p) StringBlock(next, true, size, next_size);
 }
 
@@ -147,7 +156,7 @@ inline size_t StringBlock::Delete(StringBlock* block) {
   ABSL_DCHECK(block != nullptr);
   if (!block->heap_allocated_) return size_t{0};
   size_t size = block->allocated_size();
-  internal::SizedDelete(block, size);
+  FreeHeapBlock(block, size);
   return size;
 }
 
@@ -104,6 +104,29 @@ TEST(StringBlockTest, HeapAllocateMultipleBlocks) {
   }
 }
 
+// Sanitizer builds bypass the block cache.
+#if !defined(PROTOBUF_ASAN) && !defined(PROTOBUF_MSAN)
+TEST(StringBlockTest, HeapBlocksAreRecycled) {
+  StringBlock* first = StringBlock::New(nullptr);
+  StringBlock* second = StringBlock::New(first);
+  StringBlock* third = StringBlock::New(second);
+  void* const freed = third;
+  const size_t size = third->allocated_size();
+  EXPECT_THAT(StringBlock::Delete(third), Eq(size));
+
+  // A new block of the same size reuses the memory of the deleted one.
+  StringBlock* block = StringBlock::New(second);
+  EXPECT_THAT(static_cast<void*>(block), Eq(freed));
+  EXPECT_THAT(block->allocated_size(), Eq(size));
+  EXPECT_THAT(block->next(), Eq(second));
+  ASSERT_TRUE(block->heap_allocated());
+
+  StringBlock::Delete(block);
+  StringBlock::Delete(second);
+  StringBlock::Delete(first);
+}
+#endif  // !PROTOBUF_ASAN && !PROTOBUF_MSAN
+
 TEST(StringBlockTest, EmplaceMultipleBlocks) {
   std::vector<std::unique_ptr<char[]>> buffers;
 
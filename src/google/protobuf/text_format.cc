@@ -19,6 +19,7 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <string>
@@ -26,6 +27,7 @@
 #include <vector>
 
 #include "absl/container/btree_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/cord.h"
@@ -36,7 +38,9 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "google/protobuf/any.h"
+#include "google/protobuf/arena.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/descriptor.pb.h"
 #include "google/protobuf/dynamic_message.h"
@@ -413,6 +417,21 @@ class TextFormat::Parser::ParserImpl {
     }
   }
 
+  // Makes Parse() pass the elements of the repeated message field `field` of
+  // `root` to `callback` instead of adding them to `root`.
+  void StreamRepeatedField(const FieldDescriptor* field, const Message* root,
+                           absl::FunctionRef<bool(Message&)> callback) {
+    MessageFactory* factory =
+        finder_ ? finder_->FindExtensionFactory(field) : nullptr;
+    if (factory == nullptr) {
+      factory = root->GetReflection()->GetMessageFactory();
+    }
+    streamed_field_ = field;
+    streamed_root_ = root;
+    streamed_prototype_ = factory->GetPrototype(field->message_type());
+    streamed_callback_.emplace(callback);
+  }
+
   bool ParseField(const FieldDescriptor* field, Message* output) {
     bool suc;
     if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
@@ -462,6 +481,7 @@ class TextFormat::Parser::ParserImpl {
   static constexpr int64_t kint64min = std::numeric_limits<int64_t>::min();
   static constexpr int64_t kint64max = std::numeric_limits<int64_t>::max();
   static constexpr uint64_t kuint64max = std::numeric_limits<uint64_t>::max();
+  static constexpr size_t kMinStreamedBlockSize = 4096;
 
   // Reports an error with the given message with information indicating
   // the position (as derived from the current token).
@@ -736,8 +756,9 @@ class TextFormat::Parser::ParserImpl {
     TryConsume(";") || TryConsume(",");
 
     // If a parse info tree exists, add the location for the parsed
-    // field.
-    if (parse_info_tree_ != nullptr) {
+    // field. Elements of the streamed field are not kept, so neither are their
+    // locations.
+    if (parse_info_tree_ != nullptr && !IsStreamedField(message, field)) {
       int end_line = tokenizer_.previous().line;
       int end_column = tokenizer_.previous().end_column;
 
@@ -793,17 +814,21 @@ class TextFormat::Parser::ParserImpl {
       return false;
     }
     // If the parse information tree is not nullptr, create a nested one
-    // for the nested message.
+    // for the nested message. There is none for elements of the streamed
+    // field, which would otherwise grow with the input.
+    const bool streamed = IsStreamedField(message, field);
     ParseInfoTree* parent = parse_info_tree_;
     if (parent != nullptr) {
-      parse_info_tree_ = CreateNested(parent, field);
+      parse_info_tree_ = streamed ? nullptr : CreateNested(parent, field);
     }
 
     std::string delimiter;
     DO(ConsumeMessageDelimiter(&delimiter));
     MessageFactory* factory =
         finder_ ? finder_->FindExtensionFactory(field) : nullptr;
-    if (field->is_repeated()) {
+    if (streamed) {
+      DO(ConsumeStreamedMessage(delimiter));
+    } else if (field->is_repeated()) {
       DO(ConsumeMessage(reflection->AddMessage(message, field, factory),
                         delimiter));
     } else {
@@ -818,6 +843,48 @@ class TextFormat::Parser::ParserImpl {
     return true;
   }
 
+  // Returns true if `field` of `message` is the field whose elements are
+  // passed to the callback of ParseStreamingRepeatedField().
+  bool IsStreamedField(const Message* message,
+                       const FieldDescriptor* field) const {
+    return field == streamed_field_ && message == streamed_root_;
+  }
+
+  // Consumes an element of the streamed field and passes it to the callback.
+  bool ConsumeStreamedMessage(const std::string& delimiter) {
+    Message* element = streamed_prototype_->New(ResetStreamedArena());
+    DO(ConsumeMessage(element, delimiter));
+    if (!allow_partial_ && !element->IsInitialized()) {
+      std::vector<std::string> missing_fields;
+      element->FindInitializationErrors(&missing_fields);
+      ReportError(absl::StrCat("Message missing required fields: ",
+                               absl::StrJoin(missing_fields, ", ")));
+      return false;
+    }
+    return (*streamed_callback_)(*element);
+  }
+
+  // Returns an empty arena for the next element of the streamed field. The
+  // initial block of the arena grows to the space used by the largest element
+  // so far, so that resetting the arena keeps its memory rather than freeing
+  // and reallocating blocks for every element.
+  Arena* ResetStreamedArena() {
+    if (streamed_arena_.has_value()) {
+      const uint64_t space_allocated = streamed_arena_->Reset();
+      if (space_allocated <= streamed_block_size_) return &*streamed_arena_;
+      streamed_arena_.reset();
+      streamed_block_size_ = static_cast<size_t>(space_allocated);
+    }
+    streamed_block_size_ =
+        std::max(streamed_block_size_, kMinStreamedBlockSize);
+    streamed_block_.reset(new char[streamed_block_size_]);
+    ArenaOptions options;
+    options.initial_block = streamed_block_.get();
+    options.initial_block_size = streamed_block_size_;
+    streamed_arena_.emplace(options);
+    return &*streamed_arena_;
+  }
+
   // Skips the whole body of a message including the beginning delimiter and
   // the ending delimiter.
   bool SkipFieldMessage() {
@@ -1076,7 +1143,7 @@ class TextFormat::Parser::ParserImpl {
   }
 
   // Returns true if the current token's text is equal to that specified.
-  bool LookingAt(const std::string& text) {
+  bool LookingAt(absl::string_view text) {
     return tokenizer_.current().text == text;
   }
 
@@ -1345,7 +1412,7 @@ class TextFormat::Parser::ParserImpl {
   // Consumes a token and confirms that it matches that specified in the
   // value parameter. Returns false if the token found does not match that
   // which was specified.
-  bool Consume(const std::string& value) {
+  bool Consume(absl::string_view value) {
     const std::string& current_value = tokenizer_.current().text;
 
     if (current_value != value) {
@@ -1361,7 +1428,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Similar to `Consume`, but the following token may be tokenized as
   // TYPE_WHITESPACE.
-  bool ConsumeBeforeWhitespace(const std::string& value) {
+  bool ConsumeBeforeWhitespace(absl::string_view value) {
     // Report whitespace after this token, but only once.
     tokenizer_.set_report_whitespace(true);
     bool result = Consume(value);
@@ -1371,7 +1438,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Attempts to consume the supplied value. Returns false if the token found
   // does not match the value specified.
-  bool TryConsume(const std::string& value) {
+  bool TryConsume(absl::string_view value) {
     if (tokenizer_.current().text == value) {
       tokenizer_.Next();
       return true;
@@ -1382,7 +1449,7 @@ class TextFormat::Parser::ParserImpl {
 
   // Similar to `TryConsume`, but the following token may be tokenized as
   // TYPE_WHITESPACE.
-  bool TryConsumeBeforeWhitespace(const std::string& value) {
+  bool TryConsumeBeforeWhitespace(absl::string_view value) {
     // Report whitespace after this token, but only once.
     tokenizer_.set_report_whitespace(true);
     bool result = TryConsume(value);
@@ -1393,8 +1460,10 @@ class TextFormat::Parser::ParserImpl {
   bool TryConsumeWhitespace() {
     had_silent_marker_ = false;
     if (LookingAtType(io::Tokenizer::TYPE_WHITESPACE)) {
-      if (tokenizer_.current().text ==
-          absl::StrCat(" ", internal::kDebugStringSilentMarkerForDetection)) {
+      // Compared piecewise to avoid building the marker string per token.
+      absl::string_view text = tokenizer_.current().text;
+      if (absl::StartsWith(text, " ") &&
+          text.substr(1) == internal::kDebugStringSilentMarkerForDetection) {
         had_silent_marker_ = true;
       }
       tokenizer_.Next();
@@ -1446,6 +1515,16 @@ class TextFormat::Parser::ParserImpl {
   bool had_errors_;
   UnsetFieldsMetadata* no_op_fields_{};
 
+  // Set by StreamRepeatedField().
+  const FieldDescriptor* streamed_field_ = nullptr;
+  const Message* streamed_root_ = nullptr;
+  const Message* streamed_prototype_ = nullptr;
+  absl::optional<absl::FunctionRef<bool(Message&)>> streamed_callback_;
+  // The initial block of streamed_arena_, which is declared after it so that
+  // the arena is destroyed first.
+  std::unique_ptr<char[]> streamed_block_;
+  size_t streamed_block_size_ = 0;
+  absl::optional<Arena> streamed_arena_;
 };
 
 // ===========================================================================
@@ -1509,21 +1588,21 @@ class TextFormat::Printer::TextGenerator
   // Print text to the output stream.
   void Print(const char* text, size_t size) override {
     if (indent_level_ > 0) {
-      size_t pos = 0;  // The number of bytes we've written so far.
-      for (size_t i = 0; i < size; i++) {
-        if (text[i] == '\n') {
-          // Saw newline.  If there is more text, we may need to insert an
-          // indent here.  So, write what we have so far, including the '\n'.
-          Write(text + pos, i - pos + 1);
-          pos = i + 1;
-
-          // Setting this true will cause the next Write() to insert an indent
-          // first.
-          at_start_of_line_ = true;
-        }
+      const char* end = text + size;
+      const char* newline;
+      while (text != end && (newline = static_cast<const char*>(
+                                 memchr(text, '\n', end - text))) != nullptr) {
+        // Saw newline.  If there is more text, we may need to insert an
+        // indent here.  So, write what we have so far, including the '\n'.
+        Write(text, newline - text + 1);
+        text = newline + 1;
+
+        // Setting this true will cause the next Write() to insert an indent
+        // first.
+        at_start_of_line_ = true;
       }
       // Write the rest.
-      Write(text + pos, size - pos);
+      Write(text, end - text);
     } else {
       Write(text, size);
       if (size > 0 && text[size - 1] == '\n') {
@@ -1832,6 +1911,32 @@ bool TextFormat::Parser::Parse(io::ZeroCopyInputStream* input,
   return MergeUsingImpl(input, output, &parser);
 }
 
+bool TextFormat::Parser::ParseStreamingRepeatedField(
+    io::ZeroCopyInputStream* input, const FieldDescriptor* field,
+    Message* output, absl::FunctionRef<bool(Message&)> callback) {
+  if (field == nullptr || !field->is_repeated() ||
+      field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE ||
+      field->containing_type() != output->GetDescriptor()) {
+    ABSL_DLOG(FATAL) << "Streamed field must be a repeated message field of "
+                     << output->GetDescriptor()->full_name() << ".";
+    return false;
+  }
+  output->Clear();
+
+  ParserImpl::SingularOverwritePolicy overwrites_policy =
+      allow_singular_overwrites_ ? ParserImpl::ALLOW_SINGULAR_OVERWRITES
+                                 : ParserImpl::FORBID_SINGULAR_OVERWRITES;
+
+  ParserImpl parser(output->GetDescriptor(), input, error_collector_, finder_,
+                    parse_info_tree_, overwrites_policy,
+                    allow_case_insensitive_field_, allow_unknown_field_,
+                    allow_unknown_extension_, allow_unknown_enum_,
+                    allow_field_number_, allow_relaxed_whitespace_,
+                    allow_partial_, recursion_limit_, no_op_fields_);
+  parser.StreamRepeatedField(field, output, callback);
+  return MergeUsingImpl(input, output, &parser);
+}
+
 bool TextFormat::Parser::ParseFromString(absl::string_view input,
                                          Message* output) {
   DO(CheckParseInputSize(input, error_collector_));
@@ -2016,27 +2121,31 @@ void TextFormat::FastFieldValuePrinter::PrintBool(
 }
 void TextFormat::FastFieldValuePrinter::PrintInt32(
     int32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt32(
     uint32_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintInt64(
     int64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintUInt64(
     uint64_t val, BaseTextGenerator* generator) const {
-  generator->PrintString(absl::StrCat(val));
+  generator->PrintString(absl::AlphaNum(val).Piece());
 }
 void TextFormat::FastFieldValuePrinter::PrintFloat(
     float val, BaseTextGenerator* generator) const {
-  generator->PrintString(!std::isnan(val) ? io::SimpleFtoa(val) : "nan");
+  char buffer[io::kFloatToBufferSize];
+  generator->PrintString(
+      absl::string_view(buffer, io::FloatToBuffer(val, buffer)));
 }
 void TextFormat::FastFieldValuePrinter::PrintDouble(
     double val, BaseTextGenerator* generator) const {
-  generator->PrintString(!std::isnan(val) ? io::SimpleDtoa(val) : "nan");
+  char buffer[io::kDoubleToBufferSize];
+  generator->PrintString(
+      absl::string_view(buffer, io::DoubleToBuffer(val, buffer)));
 }
 void TextFormat::FastFieldValuePrinter::PrintEnum(
     int32_t /*val*/, const std::string& name,
@@ -2200,6 +2309,7 @@ TextFormat::Printer::Printer()
       print_message_fields_in_index_order_(false),
       expand_any_(false),
       truncate_string_field_longer_than_(0LL),
+      builtin_default_field_value_printer_(true),
       finder_(nullptr) {
   SetUseUtf8StringEscaping(false);
 }
@@ -2207,16 +2317,19 @@ TextFormat::Printer::Printer()
 void TextFormat::Printer::SetUseUtf8StringEscaping(bool as_utf8) {
   SetDefaultFieldValuePrinter(as_utf8 ? new FastFieldValuePrinterUtf8Escaping()
                                       : new DebugStringFieldValuePrinter());
+  builtin_default_field_value_printer_ = true;
 }
 
 void TextFormat::Printer::SetDefaultFieldValuePrinter(
     const FieldValuePrinter* printer) {
   default_field_value_printer_.reset(new FieldValuePrinterWrapper(printer));
+  builtin_default_field_value_printer_ = false;
 }
 
 void TextFormat::Printer::SetDefaultFieldValuePrinter(
     const FastFieldValuePrinter* printer) {
   default_field_value_printer_.reset(printer);
+  builtin_default_field_value_printer_ = false;
 }
 
 bool TextFormat::Printer::RegisterFieldValuePrinter(
@@ -2661,9 +2774,9 @@ void TextFormat::Printer::PrintField(const Message& message,
   for (int j = 0; j < count; ++j) {
     const int field_index = field->is_repeated() ? j : -1;
 
-    PrintFieldName(message, field_index, count, reflection, field, generator);
-
     if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+      PrintFieldName(message, field_index, count, reflection, field,
+                     generator);
       if (TryRedactFieldValue(message, field, generator,
                               /*insert_value_separator=*/true)) {
         break;
@@ -2685,7 +2798,8 @@ void TextFormat::Printer::PrintField(const Message& message,
       printer->PrintMessageEnd(sub_message, field_index, count,
                                single_line_mode_, generator);
     } else {
-      generator->PrintMaybeWithMarker(MarkerToken(), ": ");
+      PrintFieldNameAndSeparator(message, field_index, count, reflection,
+                                 field, generator);
       // Write the field value.
       PrintFieldValue(message, reflection, field, field_index, generator);
       if (single_line_mode_) {
@@ -2730,7 +2844,7 @@ void TextFormat::Printer::PrintFieldName(const Message& message,
   // if use_field_number_ is true, prints field number instead
   // of field name.
   if (use_field_number_) {
-    generator->PrintString(absl::StrCat(field->number()));
+    generator->PrintString(absl::AlphaNum(field->number()).Piece());
     return;
   }
 
@@ -2739,6 +2853,29 @@ void TextFormat::Printer::PrintFieldName(const Message& message,
                           generator);
 }
 
+void TextFormat::Printer::PrintFieldNameAndSeparator(
+    const Message& message, int field_index, int field_count,
+    const Reflection* reflection, const FieldDescriptor* field,
+    BaseTextGenerator* generator) const {
+  // The built-in printers print a regular field by its name, so "name: " can
+  // be assembled on the stack and written at once.
+  if (!use_field_number_ && !field->is_extension() &&
+      UsesBuiltinFieldValuePrinters()) {
+    absl::string_view name = field->name();
+    char buffer[128];
+    if (name.size() + 2 <= sizeof(buffer)) {
+      memcpy(buffer, name.data(), name.size());
+      memcpy(buffer + name.size(), ": ", 2);
+      generator->PrintMaybeWithMarker(
+          MarkerToken(), absl::string_view(buffer, name.size() + 2));
+      return;
+    }
+  }
+  PrintFieldName(message, field_index, field_count, reflection, field,
+                 generator);
+  generator->PrintMaybeWithMarker(MarkerToken(), ": ");
+}
+
 void TextFormat::Printer::PrintFieldValue(const Message& message,
                                           const Reflection* reflection,
                                           const FieldDescriptor* field,
@@ -2753,15 +2890,24 @@ void TextFormat::Printer::PrintFieldValue(const Message& message,
     return;
   }
 
+  // None of the built-in printers overrides the scalar methods, so they are
+  // called directly when no custom printer can be involved.
+  const bool builtin_printer = UsesBuiltinFieldValuePrinters();
+
   switch (field->cpp_type()) {
-#define OUTPUT_FIELD(CPPTYPE, METHOD)                                \
-  case FieldDescriptor::CPPTYPE_##CPPTYPE:                           \
-    printer->Print##METHOD(                                          \
-        field->is_repeated()                                         \
-            ? reflection->GetRepeated##METHOD(message, field, index) \
-            : reflection->Get##METHOD(message, field),               \
-        generator);                                                  \
-    break
+#define OUTPUT_FIELD(CPPTYPE, METHOD)                                    \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE: {                             \
+    const auto value =                                                   \
+        field->is_repeated()                                             \
+            ? reflection->GetRepeated##METHOD(message, field, index)     \
+            : reflection->Get##METHOD(message, field);                   \
+    if (builtin_printer) {                                               \
+      printer->FastFieldValuePrinter::Print##METHOD(value, generator);   \
+    } else {                                                             \
+      printer->Print##METHOD(value, generator);                          \
+    }                                                                    \
+    break;                                                               \
+  }
 
     OUTPUT_FIELD(INT32, Int32);
     OUTPUT_FIELD(INT64, Int64);
@@ -2805,8 +2951,14 @@ void TextFormat::Printer::PrintFieldValue(const Message& message,
       const EnumValueDescriptor* enum_desc =
           field->enum_type()->FindValueByNumber(enum_value);
       if (enum_desc != nullptr) {
-        printer->PrintEnum(enum_value, internal::NameOfEnumAsString(enum_desc),
-                           generator);
+        if (builtin_printer) {
+          printer->FastFieldValuePrinter::PrintEnum(
+              enum_value, internal::NameOfEnumAsString(enum_desc), generator);
+        } else {
+          printer->PrintEnum(enum_value,
+                             internal::NameOfEnumAsString(enum_desc),
+                             generator);
+        }
       } else {
         // Ordinarily, enum_desc should not be null, because proto2 has the
         // invariant that set enum field values must be in-range, but with the
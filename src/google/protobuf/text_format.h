@@ -22,6 +22,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.h"
@@ -507,6 +508,13 @@ class PROTOBUF_EXPORT TextFormat {
                         const FieldDescriptor* field,
                         BaseTextGenerator* generator) const;
 
+    // Print the name of a non-message field followed by the ':' separator.
+    void PrintFieldNameAndSeparator(const Message& message, int field_index,
+                                    int field_count,
+                                    const Reflection* reflection,
+                                    const FieldDescriptor* field,
+                                    BaseTextGenerator* generator) const;
+
     // Outputs a textual representation of the value of the field supplied on
     // the message supplied or the default value if not set.
     void PrintFieldValue(const Message& message, const Reflection* reflection,
@@ -531,11 +539,19 @@ class PROTOBUF_EXPORT TextFormat {
 
     const FastFieldValuePrinter* GetFieldPrinter(
         const FieldDescriptor* field) const {
+      if (custom_printers_.empty()) return default_field_value_printer_.get();
       auto it = custom_printers_.find(field);
       return it == custom_printers_.end() ? default_field_value_printer_.get()
                                           : it->second.get();
     }
 
+    // True if every field is printed by one of the built-in printers, whose
+    // scalar and field name methods can then be called without virtual
+    // dispatch.
+    bool UsesBuiltinFieldValuePrinters() const {
+      return builtin_default_field_value_printer_ && custom_printers_.empty();
+    }
+
     friend class google::protobuf::python::cmessage::PythonFieldValuePrinter;
     static void HardenedPrintString(absl::string_view src,
                                     TextFormat::BaseTextGenerator* generator);
@@ -554,6 +570,7 @@ class PROTOBUF_EXPORT TextFormat {
     int64_t truncate_string_field_longer_than_;
 
     std::unique_ptr<const FastFieldValuePrinter> default_field_value_printer_;
+    bool builtin_default_field_value_printer_;
     absl::flat_hash_map<const FieldDescriptor*,
                         std::unique_ptr<const FastFieldValuePrinter>>
         custom_printers_;
@@ -682,6 +699,23 @@ class PROTOBUF_EXPORT TextFormat {
     // Like TextFormat::MergeFromString().
     bool MergeFromString(absl::string_view input, Message* output);
 
+    // Like Parse(), but the elements of `field`, a repeated message field of
+    // the top-level message, are passed to `callback` one at a time instead of
+    // being added to `output`. The other fields are parsed into `output` as
+    // usual.
+    //
+    // Each element is parsed into a message on an arena that is reset between
+    // elements while keeping its memory, so memory use is bounded by the
+    // largest element rather than by the whole input. The element passed to
+    // `callback` is only valid until it returns. Parsing stops and returns
+    // false as soon as `callback` returns false.
+    //
+    // The tree passed to WriteLocationsTo() gets no locations for `field` or
+    // its elements, as it would otherwise grow with the input.
+    bool ParseStreamingRepeatedField(
+        io::ZeroCopyInputStream* input, const FieldDescriptor* field,
+        Message* output, absl::FunctionRef<bool(Message&)> callback);
+
     // Set where to report parse errors.  If nullptr (the default), errors will
     // be printed to stderr.
     void RecordErrorsTo(io::ErrorCollector* error_collector) {
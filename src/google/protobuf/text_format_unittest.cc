@@ -78,6 +78,7 @@ namespace text_format_unittest {
 using ::google::protobuf::internal::kDebugStringSilentMarker;
 using ::google::protobuf::internal::UnsetFieldsMetadataTextFormatTestUtil;
 using ::testing::AllOf;
+using ::testing::ElementsAreArray;
 using ::testing::HasSubstr;
 using ::testing::UnorderedElementsAre;
 
@@ -642,6 +643,30 @@ TEST_F(TextFormatTest, DefaultCustomFieldPrinter) {
   EXPECT_EQ("optional_uint32: 42u\nrepeated_uint32: [1u, 2u, 3u]\n", text);
 }
 
+TEST_F(TextFormatTest, DefaultCustomFieldPrinterReplacedByBuiltin) {
+  protobuf_unittest::TestAllTypes message;
+
+  message.set_optional_uint32(42);
+  message.add_repeated_uint32(1);
+  message.set_optional_nested_enum(protobuf_unittest::TestAllTypes::BAR);
+
+  TextFormat::Printer printer;
+  printer.SetDefaultFieldValuePrinter(new CustomUInt32FieldValuePrinter());
+  std::string text;
+  printer.PrintToString(message, &text);
+  EXPECT_EQ(
+      "optional_uint32: 42u\noptional_nested_enum: BAR\n"
+      "repeated_uint32: 1u\n",
+      text);
+
+  printer.SetUseUtf8StringEscaping(false);
+  printer.PrintToString(message, &text);
+  EXPECT_EQ(
+      "optional_uint32: 42\noptional_nested_enum: BAR\n"
+      "repeated_uint32: 1\n",
+      text);
+}
+
 class CustomInt32FieldValuePrinter : public TextFormat::FieldValuePrinter {
  public:
   std::string PrintInt32(int32_t val) const override {
@@ -1582,6 +1607,37 @@ TEST_F(TextFormatTest, PrintFloatPrecision) {
             RemoveRedundantZeros(message.DebugString()));
 }
 
+TEST_F(TextFormatTest, PrintFloatShortestRoundTrip) {
+  unittest::TestAllTypes message;
+
+  // Values are printed with the shortest digits that parse back to them, even
+  // when those are more than FLT_DIG or DBL_DIG.
+  message.add_repeated_float(123456.7f);
+  message.add_repeated_float(std::numeric_limits<float>::max());
+  message.add_repeated_float(std::numeric_limits<float>::denorm_min());
+  message.add_repeated_double(0.1 + 0.2);
+  message.add_repeated_double(std::numeric_limits<double>::max());
+  message.add_repeated_double(std::numeric_limits<double>::denorm_min());
+  message.add_repeated_double(-0.0);
+
+  EXPECT_EQ(absl::StrCat(multi_line_debug_format_prefix_,
+                         "repeated_float: 123456.7\n"
+                         "repeated_float: 3.4028235e+38\n"
+                         "repeated_float: 1e-45\n"
+                         "repeated_double: 0.30000000000000004\n"
+                         "repeated_double: 1.7976931348623157e+308\n"
+                         "repeated_double: 5e-324\n"
+                         "repeated_double: -0\n"),
+            message.DebugString());
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(TextFormat::ParseFromString(message.DebugString(), &parsed));
+  EXPECT_THAT(parsed.repeated_float(),
+              ElementsAreArray(message.repeated_float()));
+  EXPECT_THAT(parsed.repeated_double(),
+              ElementsAreArray(message.repeated_double()));
+}
+
 TEST_F(TextFormatTest, AllowPartial) {
   unittest::TestRequired message;
   TextFormat::Parser parser;
@@ -2248,6 +2304,123 @@ TEST_F(TextFormatParserTest, MergeDuplicateOptional) {
   EXPECT_EQ(2, message.c());
 }
 
+TEST_F(TextFormatParserTest, ParseStreamingRepeatedField) {
+  const std::string input =
+      "optional_int32: 1\n"
+      "repeated_nested_message { bb: 1 }\n"
+      "repeated_nested_message: [{ bb: 2 }, < bb: 3 >]\n"
+      "optional_nested_message { bb: 4 }\n"
+      "optional_string: \"x\"\n";
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  unittest::TestAllTypes message;
+  std::vector<int> values;
+  EXPECT_TRUE(parser_.ParseStreamingRepeatedField(
+      &input_stream,
+      unittest::TestAllTypes::descriptor()->FindFieldByName(
+          "repeated_nested_message"),
+      &message, [&](Message& element) {
+        EXPECT_NE(element.GetArena(), nullptr);
+        values.push_back(
+            DownCastMessage<unittest::TestAllTypes::NestedMessage>(element)
+                .bb());
+        return true;
+      }));
+  EXPECT_THAT(values, testing::ElementsAre(1, 2, 3));
+  EXPECT_EQ(1, message.optional_int32());
+  EXPECT_EQ(4, message.optional_nested_message().bb());
+  EXPECT_EQ("x", message.optional_string());
+  EXPECT_EQ(0, message.repeated_nested_message_size());
+}
+
+TEST_F(TextFormatParserTest, ParseStreamingRepeatedFieldStopsOnCallback) {
+  const std::string input =
+      "repeated_nested_message { bb: 1 } repeated_nested_message { bb: 2 } "
+      "repeated_nested_message { bb: 3 }";
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  unittest::TestAllTypes message;
+  int calls = 0;
+  EXPECT_FALSE(parser_.ParseStreamingRepeatedField(
+      &input_stream,
+      unittest::TestAllTypes::descriptor()->FindFieldByName(
+          "repeated_nested_message"),
+      &message, [&](Message&) { return ++calls < 2; }));
+  EXPECT_EQ(2, calls);
+}
+
+TEST_F(TextFormatParserTest, ParseStreamingRepeatedFieldMissingRequired) {
+  const std::string input = "repeated_message { a: 1 }";
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  unittest::TestRequiredForeign message;
+  MockErrorCollector error_collector;
+  parser_.RecordErrorsTo(&error_collector);
+  EXPECT_FALSE(parser_.ParseStreamingRepeatedField(
+      &input_stream,
+      unittest::TestRequiredForeign::descriptor()->FindFieldByName(
+          "repeated_message"),
+      &message, [](Message&) { return true; }));
+  EXPECT_EQ("1:26: Message missing required fields: b, c\n",
+            error_collector.text_);
+  parser_.RecordErrorsTo(nullptr);
+}
+
+TEST_F(TextFormatParserTest, ParseStreamingRepeatedFieldLocations) {
+  const std::string input =
+      "optional_int32: 1\n"
+      "repeated_nested_message { bb: 1 }\n"
+      "repeated_nested_message { bb: 2 }\n"
+      "optional_nested_message { bb: 3 }\n";
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  unittest::TestAllTypes message;
+  const Descriptor* d = message.GetDescriptor();
+  const FieldDescriptor* streamed =
+      d->FindFieldByName("repeated_nested_message");
+  TextFormat::ParseInfoTree tree;
+  parser_.WriteLocationsTo(&tree);
+  EXPECT_TRUE(parser_.ParseStreamingRepeatedField(
+      &input_stream, streamed, &message, [](Message&) { return true; }));
+  parser_.WriteLocationsTo(nullptr);
+
+  ExpectLocation(&tree, d, "optional_int32", -1, 0, 0, 0, 17);
+  ExpectLocation(&tree, d, "optional_nested_message", -1, 3, 0, 3, 33);
+  EXPECT_NE(nullptr, tree.GetTreeForNested(
+                         d->FindFieldByName("optional_nested_message"), -1));
+  // The elements of the streamed field have neither a location nor a tree.
+  ExpectLocation(&tree, d, "repeated_nested_message", 0, -1, -1, -1, -1);
+  EXPECT_EQ(nullptr, tree.GetTreeForNested(streamed, 0));
+}
+
+TEST_F(TextFormatParserTest, ParseStreamingRepeatedFieldLargeElements) {
+  // Elements larger than the arena block, so that the block grows, then
+  // smaller ones that reuse it.
+  const std::vector<size_t> sizes = {10, 20000, 100, 100000, 5000, 10};
+  std::string input;
+  for (size_t size : sizes) {
+    absl::StrAppend(&input, "repeated_child { payload { optional_string: \"",
+                    std::string(size, 'x'), "\" repeated_int32: [");
+    for (size_t i = 0; i < size / 100; ++i) {
+      absl::StrAppend(&input, i > 0 ? ", " : "", i);
+    }
+    absl::StrAppend(&input, "] } }\n");
+  }
+  io::ArrayInputStream input_stream(input.data(), input.size());
+  unittest::NestedTestAllTypes message;
+  std::vector<size_t> values;
+  EXPECT_TRUE(parser_.ParseStreamingRepeatedField(
+      &input_stream,
+      unittest::NestedTestAllTypes::descriptor()->FindFieldByName(
+          "repeated_child"),
+      &message, [&](Message& element) {
+        const auto& payload =
+            DownCastMessage<unittest::NestedTestAllTypes>(element).payload();
+        const size_t size = payload.optional_string().size();
+        EXPECT_EQ(payload.repeated_int32_size(), static_cast<int>(size / 100));
+        values.push_back(size);
+        return true;
+      }));
+  EXPECT_EQ(values, sizes);
+  EXPECT_EQ(0, message.repeated_child_size());
+}
+
 TEST_F(TextFormatParserTest, ExplicitDelimiters) {
   unittest::TestRequired message;
   EXPECT_TRUE(TextFormat::ParseFromString("a:1,b:2;c:3", &message));
@@ -82,6 +82,14 @@ class PROTOBUF_EXPORT ThreadSafeArena {
     }
   }
 
+  bool TryExtendArrayInPlace(void* p, size_t old_size, size_t new_size) {
+    SerialArena* arena = nullptr;
+    if (PROTOBUF_PREDICT_TRUE(GetSerialArenaFast(&arena))) {
+      return arena->TryExtendArrayInPlace(p, old_size, new_size);
+    }
+    return false;
+  }
+
   // This function allocates n bytes if the common happy case is true and
   // returns true. Otherwise does nothing and returns false. This strange
   // semantics is necessary to allow callers to program functions that only
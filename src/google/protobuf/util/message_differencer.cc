@@ -17,11 +17,14 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "google/protobuf/descriptor.pb.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "absl/strings/escaping.h"
@@ -149,6 +152,11 @@ class MessageDifferencer::MultipleFieldsMapKeyComparator
     return true;
   }
 
+  const std::vector<std::vector<const FieldDescriptor*> >& key_field_paths()
+      const {
+    return key_field_paths_;
+  }
+
  private:
   bool IsMatchInternal(
       const Message& message1, const Message& message2, int unpacked_any,
@@ -1897,8 +1905,162 @@ bool MaximumMatcher::FindArgumentPathDFS(int v, std::vector<bool>* visited) {
   return false;
 }
 
+// Whether values of `field` can be hashed so that values the default field
+// comparator considers equal always hash equally. Floating point values are
+// excluded since they may be compared with a margin or with NaN == NaN.
+bool IsFingerprintableField(const FieldDescriptor* field) {
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_FLOAT:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return false;
+    default:
+      return true;
+  }
+}
+
+// Mixes the value of `field` into `hash`. `index` is only used for repeated
+// fields.
+size_t HashFieldValue(size_t hash, const Message& message,
+                      const FieldDescriptor* field, int index,
+                      std::string* scratch) {
+  const Reflection* reflection = message.GetReflection();
+  const bool repeated = field->is_repeated();
+  switch (field->cpp_type()) {
+#define HASH_FIELD(CPPTYPE, METHOD)                                        \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                                 \
+    return absl::HashOf(                                                   \
+        hash, repeated                                                     \
+                  ? reflection->GetRepeated##METHOD(message, field, index) \
+                  : reflection->Get##METHOD(message, field));
+
+    HASH_FIELD(INT32, Int32);
+    HASH_FIELD(INT64, Int64);
+    HASH_FIELD(UINT32, UInt32);
+    HASH_FIELD(UINT64, UInt64);
+    HASH_FIELD(BOOL, Bool);
+    HASH_FIELD(ENUM, EnumValue);
+#undef HASH_FIELD
+
+    case FieldDescriptor::CPPTYPE_STRING:
+      return absl::HashOf(
+          hash, repeated ? reflection->GetRepeatedStringReference(
+                               message, field, index, scratch)
+                         : reflection->GetStringReference(message, field,
+                                                          scratch));
+    default:
+      ABSL_LOG(FATAL) << "Field cannot be fingerprinted: "
+                      << field->full_name();
+      return hash;
+  }
+}
+
+// Mixes the value at the end of `path` into `hash`. Intermediate messages
+// which are not set contribute a marker instead, mirroring the way
+// MultipleFieldsMapKeyComparator treats two unset key paths as equal.
+size_t HashFieldPath(size_t hash, const Message& message,
+                     const std::vector<const FieldDescriptor*>& path,
+                     std::string* scratch) {
+  const Message* current = &message;
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    const Reflection* reflection = current->GetReflection();
+    if (!reflection->HasField(*current, path[i])) {
+      return absl::HashOf(hash, false);
+    }
+    current = &reflection->GetMessage(*current, path[i]);
+  }
+  return HashFieldValue(absl::HashOf(hash, true), *current, path.back(), -1,
+                        scratch);
+}
+
+// Elements of a repeated field sharing one fingerprint, in index order.
+// `first_unmatched` skips the prefix of `indices` which is already matched so
+// that runs of identical elements are consumed in linear time.
+struct FingerprintBucket {
+  std::vector<int> indices;
+  size_t first_unmatched = 0;
+};
+
 }  // namespace
 
+bool MessageDifferencer::FingerprintRepeatedField(
+    const Message& message, const FieldDescriptor* repeated_field,
+    const MapKeyComparator* key_comparator,
+    std::vector<size_t>* fingerprints) const {
+  // Custom comparators and partial matching may consider elements with
+  // different values a match, so no fingerprint is safe for them.
+  if (field_comparator_kind_ != kFCDefault || scope_ == PARTIAL) {
+    return false;
+  }
+
+  const Reflection* reflection = message.GetReflection();
+  const int count = reflection->FieldSize(message, repeated_field);
+  std::string scratch;
+  if (repeated_field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (!IsFingerprintableField(repeated_field)) return false;
+    fingerprints->resize(count);
+    for (int i = 0; i < count; ++i) {
+      (*fingerprints)[i] =
+          HashFieldValue(0, message, repeated_field, i, &scratch);
+    }
+    return true;
+  }
+
+  // Collect the paths to the singular fields whose values every pair of
+  // matching elements must agree on. Leaving a field out only makes the
+  // buckets coarser, so anything that is not obviously safe is skipped.
+  std::vector<std::vector<const FieldDescriptor*> > paths;
+  const Descriptor* descriptor = repeated_field->message_type();
+  if (key_comparator == &map_entry_key_comparator_) {
+    const FieldDescriptor* key = descriptor->FindFieldByNumber(1);
+    if (!ignore_criteria_.empty() || ignored_fields_.contains(key)) {
+      return false;
+    }
+    paths.push_back({key});
+  } else if (key_comparator != nullptr) {
+    // Only the key comparators created by TreatAsMap*() have known keys.
+    if (std::find(owned_key_comparators_.begin(), owned_key_comparators_.end(),
+                  key_comparator) == owned_key_comparators_.end()) {
+      return false;
+    }
+    for (const auto& path :
+         static_cast<const MultipleFieldsMapKeyComparator*>(key_comparator)
+             ->key_field_paths()) {
+      if (path.back()->is_repeated() || !IsFingerprintableField(path.back())) {
+        continue;
+      }
+      paths.push_back(path);
+    }
+  } else {
+    // Any is compared by its unpacked payload rather than its fields.
+    if (!ignore_criteria_.empty() ||
+        descriptor->full_name() == internal::kAnyFullTypeName) {
+      return false;
+    }
+    for (int i = 0; i < descriptor->field_count(); ++i) {
+      const FieldDescriptor* field = descriptor->field(i);
+      if (field->is_repeated() || !IsFingerprintableField(field) ||
+          ignored_fields_.contains(field)) {
+        continue;
+      }
+      paths.push_back({field});
+    }
+  }
+  if (paths.empty()) return false;
+
+  fingerprints->resize(count);
+  for (int i = 0; i < count; ++i) {
+    const Message& element =
+        reflection->GetRepeatedMessage(message, repeated_field, i);
+    size_t hash = 0;
+    for (const auto& path : paths) {
+      hash = HashFieldPath(hash, element, path, &scratch);
+    }
+    (*fingerprints)[i] = hash;
+  }
+  return true;
+}
+
 bool MessageDifferencer::MatchRepeatedFieldIndices(
     const Message& message1, const Message& message2, int unpacked_any,
     const FieldDescriptor* repeated_field,
@@ -1985,12 +2147,57 @@ bool MessageDifferencer::MatchRepeatedFieldIndices(
         }
       }
     }
+    // Bucket the remaining elements of message2 by fingerprint so that every
+    // element of message1 is only compared against the candidates which can
+    // possibly match it. Fingerprints never separate elements which IsMatch()
+    // would pair and buckets keep index order, so the greedy matching below
+    // pairs the same elements as a scan over all of message2 would. Smart
+    // sets need to score every candidate and always take the full scan.
+    absl::flat_hash_map<size_t, FingerprintBucket> buckets;
+    std::vector<size_t> fingerprints1;
+    std::vector<size_t> fingerprints2;
+    const bool use_buckets =
+        !is_treated_as_smart_set && start_offset < count1 &&
+        start_offset < count2 &&
+        FingerprintRepeatedField(message1, repeated_field, key_comparator,
+                                 &fingerprints1) &&
+        FingerprintRepeatedField(message2, repeated_field, key_comparator,
+                                 &fingerprints2);
+    if (use_buckets) {
+      for (int j = start_offset; j < count2; ++j) {
+        buckets[fingerprints2[j]].indices.push_back(j);
+      }
+    }
+
     for (int i = start_offset; i < count1; ++i) {
       // Indicates any matched elements for this repeated field.
       bool match = false;
       int matched_j = -1;
 
-      for (int j = start_offset; j < count2; j++) {
+      const std::vector<int>* candidates = nullptr;
+      size_t first_candidate = 0;
+      size_t num_candidates = static_cast<size_t>(count2 - start_offset);
+      if (use_buckets) {
+        auto it = buckets.find(fingerprints1[i]);
+        if (it == buckets.end()) {
+          num_candidates = 0;
+        } else {
+          FingerprintBucket& bucket = it->second;
+          while (bucket.first_unmatched < bucket.indices.size() &&
+                 match_list2->at(bucket.indices[bucket.first_unmatched]) !=
+                     -1) {
+            ++bucket.first_unmatched;
+          }
+          candidates = &bucket.indices;
+          first_candidate = bucket.first_unmatched;
+          num_candidates = bucket.indices.size();
+        }
+      }
+
+      for (size_t k = first_candidate; k < num_candidates; ++k) {
+        const int j = candidates != nullptr
+                          ? (*candidates)[k]
+                          : start_offset + static_cast<int>(k);
         if (match_list2->at(j) != -1) {
           if (!is_treated_as_smart_set || num_diffs_list1[i] == 0 ||
               num_diffs_list1[match_list2->at(j)] == 0) {
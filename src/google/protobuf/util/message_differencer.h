@@ -20,6 +20,7 @@
 #ifndef GOOGLE_PROTOBUF_UTIL_MESSAGE_DIFFERENCER_H__
 #define GOOGLE_PROTOBUF_UTIL_MESSAGE_DIFFERENCER_H__
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -918,6 +919,16 @@ class PROTOBUF_EXPORT MessageDifferencer {
       const std::vector<SpecificField>& parent_fields,
       std::vector<int>* match_list1, std::vector<int>* match_list2);
 
+  // Computes a fingerprint for every element of the repeated field such that
+  // two elements which IsMatch() would pair always share a fingerprint. The
+  // converse does not hold, so equal fingerprints still need to be compared.
+  // Returns false if no such fingerprint can be derived under the current
+  // settings, e.g. when a custom FieldComparator is installed.
+  bool FingerprintRepeatedField(const Message& message,
+                                const FieldDescriptor* repeated_field,
+                                const MapKeyComparator* key_comparator,
+                                std::vector<size_t>* fingerprints) const;
+
   // Checks if index is equal to new_index in all the specific fields.
   static bool CheckPathChanged(const std::vector<SpecificField>& parent_fields);
 
@@ -2061,6 +2061,77 @@ TEST(MessageDifferencerTest, RepeatedFieldSetTest_Duplicates) {
   EXPECT_FALSE(differencer1.Compare(c, a));
 }
 
+TEST(MessageDifferencerTest, RepeatedFieldSetTest_LargeShuffled) {
+  protobuf_unittest::TestDiffMessage msg1;
+  for (int i = 0; i < 5000; ++i) {
+    msg1.add_rv(i % 1000);
+    msg1.add_rw(absl::StrCat("w", i % 700));
+    protobuf_unittest::TestDiffMessage::Item* item = msg1.add_item();
+    item->set_a(i % 300);
+    item->set_b(absl::StrCat("b", i));
+    item->add_ra(i);
+  }
+  protobuf_unittest::TestDiffMessage msg2 = msg1;
+  std::default_random_engine rng;
+  std::shuffle(msg2.mutable_rv()->begin(), msg2.mutable_rv()->end(), rng);
+  std::shuffle(msg2.mutable_rw()->begin(), msg2.mutable_rw()->end(), rng);
+  std::shuffle(msg2.mutable_item()->pointer_begin(),
+               msg2.mutable_item()->pointer_end(), rng);
+
+  util::MessageDifferencer differencer;
+  differencer.set_repeated_field_comparison(util::MessageDifferencer::AS_SET);
+  EXPECT_TRUE(differencer.Compare(msg1, msg2));
+  EXPECT_TRUE(differencer.Compare(msg2, msg1));
+
+  msg2.set_rv(17, 1000);
+  msg2.set_rw(42, "w700");
+  msg2.mutable_item(99)->add_ra(-1);
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+
+  // A FieldComparator that is not a DefaultFieldComparator disables the
+  // fingerprinting, so both differencers must report the same differences.
+  std::string output;
+  differencer.ReportDifferencesToString(&output);
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+
+  util::DefaultFieldComparator default_comparator;
+  util::MessageDifferencer unhashed_differencer;
+  unhashed_differencer.set_repeated_field_comparison(
+      util::MessageDifferencer::AS_SET);
+  unhashed_differencer.set_field_comparator(
+      static_cast<util::FieldComparator*>(&default_comparator));
+  std::string unhashed_output;
+  unhashed_differencer.ReportDifferencesToString(&unhashed_output);
+  EXPECT_FALSE(unhashed_differencer.Compare(msg1, msg2));
+  EXPECT_EQ(unhashed_output, output);
+}
+
+TEST(MessageDifferencerTest, RepeatedFieldMapTest_LargeShuffled) {
+  protobuf_unittest::TestDiffMessage msg1;
+  for (int i = 0; i < 5000; ++i) {
+    protobuf_unittest::TestDiffMessage::Item* item = msg1.add_item();
+    item->set_a(i);
+    item->set_b(absl::StrCat("b", i));
+  }
+  protobuf_unittest::TestDiffMessage msg2 = msg1;
+  std::default_random_engine rng;
+  std::shuffle(msg2.mutable_item()->pointer_begin(),
+               msg2.mutable_item()->pointer_end(), rng);
+
+  util::MessageDifferencer differencer;
+  differencer.TreatAsMap(GetFieldDescriptor(msg1, "item"),
+                         GetFieldDescriptor(msg1, "item.a"));
+  EXPECT_TRUE(differencer.Compare(msg1, msg2));
+
+  for (protobuf_unittest::TestDiffMessage::Item& item : *msg2.mutable_item()) {
+    if (item.a() == 1234) item.set_b("changed");
+  }
+  std::string output;
+  differencer.ReportDifferencesToString(&output);
+  EXPECT_FALSE(differencer.Compare(msg1, msg2));
+  EXPECT_THAT(output, testing::HasSubstr(".b: \"b1234\" -> \"changed\"\n"));
+}
+
 TEST(MessageDifferencerTest, RepeatedFieldSetTest_PartialSimple) {
   protobuf_unittest::TestDiffMessage a, b, c;
   // message a: {
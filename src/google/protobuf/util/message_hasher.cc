@@ -0,0 +1,247 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_hasher.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/log/absl_log.h"
+#include "google/protobuf/any.h"
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/map_field.h"
+#include "google/protobuf/message.h"
+#include "google/protobuf/util/message_differencer.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+namespace {
+
+// MessageDifferencer compares floating point values with ==, under which
+// -0.0 and 0.0 are equal, so both have to hash the same.
+double NormalizeZero(double value) { return value == 0 ? 0.0 : value; }
+
+size_t HashMapKey(const MapKey& key) {
+  switch (key.type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return absl::HashOf(key.GetInt32Value());
+    case FieldDescriptor::CPPTYPE_INT64:
+      return absl::HashOf(key.GetInt64Value());
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return absl::HashOf(key.GetUInt32Value());
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return absl::HashOf(key.GetUInt64Value());
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return absl::HashOf(key.GetBoolValue());
+    case FieldDescriptor::CPPTYPE_STRING:
+      return absl::HashOf(key.GetStringValue());
+    default:
+      ABSL_LOG(FATAL) << "Unsupported map key type: " << key.type();
+      return 0;
+  }
+}
+
+size_t HashMapValue(size_t hash, const MapValueConstRef& value) {
+  switch (value.type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return absl::HashOf(hash, value.GetInt32Value());
+    case FieldDescriptor::CPPTYPE_INT64:
+      return absl::HashOf(hash, value.GetInt64Value());
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return absl::HashOf(hash, value.GetUInt32Value());
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return absl::HashOf(hash, value.GetUInt64Value());
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return absl::HashOf(hash, NormalizeZero(value.GetDoubleValue()));
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return absl::HashOf(hash, NormalizeZero(value.GetFloatValue()));
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return absl::HashOf(hash, value.GetBoolValue());
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return absl::HashOf(hash, value.GetEnumValue());
+    case FieldDescriptor::CPPTYPE_STRING:
+      return absl::HashOf(hash, value.GetStringValue());
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      return absl::HashOf(hash, MessageHasher::Hash(value.GetMessageValue()));
+  }
+  return hash;
+}
+
+}  // namespace
+
+size_t MessageHasher::Hash(const Message& message) {
+  const Descriptor* descriptor = message.GetDescriptor();
+  if (descriptor->full_name() == internal::kAnyFullTypeName) {
+    return HashAny(message);
+  }
+  return HashFields(0, message);
+}
+
+size_t MessageHasher::HashAny(const Message& any) {
+  const FieldDescriptor* type_url_field;
+  const FieldDescriptor* value_field;
+  if (!internal::GetAnyFieldDescriptors(any, &type_url_field, &value_field)) {
+    return HashFields(0, any);
+  }
+  // MessageDifferencer compares the unpacked payloads of Any, which may be
+  // serialized differently even when equal, so only the type is hashed. The
+  // payload type is resolved from the full type name alone, so URLs which
+  // differ only in their prefix have to hash equally.
+  std::string scratch;
+  const std::string& type_url =
+      any.GetReflection()->GetStringReference(any, type_url_field, &scratch);
+  std::string full_type_name;
+  if (internal::ParseAnyTypeUrl(type_url, &full_type_name)) {
+    return absl::HashOf(full_type_name);
+  }
+  // Such an Any cannot be unpacked and is compared field by field.
+  return absl::HashOf(type_url);
+}
+
+size_t MessageHasher::HashFields(size_t hash, const Message& message) {
+  const Descriptor* descriptor = message.GetDescriptor();
+  const Reflection* reflection = message.GetReflection();
+  // Walk the descriptor rather than calling ListFields() so that hashing
+  // does not allocate. Both visit the fields in a fixed order per type.
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    hash = HashField(hash, message, descriptor->field(i));
+  }
+  if (descriptor->extension_range_count() > 0) {
+    std::vector<const FieldDescriptor*> fields;
+    reflection->ListFields(message, &fields);
+    for (const FieldDescriptor* field : fields) {
+      if (field->is_extension()) hash = HashField(hash, message, field);
+    }
+  }
+  return hash;
+}
+
+size_t MessageHasher::HashField(size_t hash, const Message& message,
+                                const FieldDescriptor* field) {
+  const Reflection* reflection = message.GetReflection();
+  if (field->is_map()) return HashMapField(hash, message, field);
+
+  if (!field->is_repeated()) {
+    if (!reflection->HasField(message, field)) return hash;
+    hash = absl::HashOf(hash, field->number());
+    switch (field->cpp_type()) {
+#define HASH_SINGULAR(CPPTYPE, METHOD)     \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE: \
+    return absl::HashOf(hash, reflection->Get##METHOD(message, field));
+
+      HASH_SINGULAR(INT32, Int32);
+      HASH_SINGULAR(INT64, Int64);
+      HASH_SINGULAR(UINT32, UInt32);
+      HASH_SINGULAR(UINT64, UInt64);
+      HASH_SINGULAR(BOOL, Bool);
+      HASH_SINGULAR(ENUM, EnumValue);
+#undef HASH_SINGULAR
+
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        return absl::HashOf(
+            hash, NormalizeZero(reflection->GetDouble(message, field)));
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        return absl::HashOf(
+            hash, NormalizeZero(reflection->GetFloat(message, field)));
+      case FieldDescriptor::CPPTYPE_STRING: {
+        std::string scratch;
+        return absl::HashOf(
+            hash, reflection->GetStringReference(message, field, &scratch));
+      }
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        return absl::HashOf(hash, Hash(reflection->GetMessage(message, field)));
+    }
+    return hash;
+  }
+
+  const int size = reflection->FieldSize(message, field);
+  if (size == 0) return hash;
+  hash = absl::HashOf(hash, field->number(), size);
+  switch (field->cpp_type()) {
+#define HASH_REPEATED(CPPTYPE, METHOD)                               \
+  case FieldDescriptor::CPPTYPE_##CPPTYPE:                           \
+    for (int i = 0; i < size; ++i) {                                 \
+      hash = absl::HashOf(                                           \
+          hash, reflection->GetRepeated##METHOD(message, field, i)); \
+    }                                                                \
+    break;
+
+    HASH_REPEATED(INT32, Int32);
+    HASH_REPEATED(INT64, Int64);
+    HASH_REPEATED(UINT32, UInt32);
+    HASH_REPEATED(UINT64, UInt64);
+    HASH_REPEATED(BOOL, Bool);
+    HASH_REPEATED(ENUM, EnumValue);
+#undef HASH_REPEATED
+
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      for (int i = 0; i < size; ++i) {
+        hash = absl::HashOf(
+            hash,
+            NormalizeZero(reflection->GetRepeatedDouble(message, field, i)));
+      }
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      for (int i = 0; i < size; ++i) {
+        hash = absl::HashOf(
+            hash,
+            NormalizeZero(reflection->GetRepeatedFloat(message, field, i)));
+      }
+      break;
+    case FieldDescriptor::CPPTYPE_STRING: {
+      std::string scratch;
+      for (int i = 0; i < size; ++i) {
+        hash = absl::HashOf(hash, reflection->GetRepeatedStringReference(
+                                      message, field, i, &scratch));
+      }
+      break;
+    }
+    case FieldDescriptor::CPPTYPE_MESSAGE:
+      for (int i = 0; i < size; ++i) {
+        hash = absl::HashOf(
+            hash, Hash(reflection->GetRepeatedMessage(message, field, i)));
+      }
+      break;
+  }
+  return hash;
+}
+
+size_t MessageHasher::HashMapField(size_t hash, const Message& message,
+                                   const FieldDescriptor* field) {
+  const Reflection* reflection = message.GetReflection();
+  const int size = reflection->MapSize(message, field);
+  if (size == 0) return hash;
+
+  // Entries are hashed independently and summed so that the result does not
+  // depend on the iteration order of the map.
+  Message* mutable_message = const_cast<Message*>(&message);
+  size_t entries = 0;
+  for (MapIterator it = reflection->MapBegin(mutable_message, field),
+                   end = reflection->MapEnd(mutable_message, field);
+       it != end; ++it) {
+    entries += HashMapValue(HashMapKey(it.GetKey()), it.GetValueRef());
+  }
+  return absl::HashOf(hash, field->number(), size, entries);
+}
+
+bool MessageEquals::operator()(const Message& message1,
+                               const Message& message2) const {
+  return MessageDifferencer::Equals(message1, message2);
+}
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
@@ -0,0 +1,97 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+// Defines utilities for hashing the contents of messages without serializing
+// them.
+
+#ifndef GOOGLE_PROTOBUF_UTIL_MESSAGE_HASHER_H__
+#define GOOGLE_PROTOBUF_UTIL_MESSAGE_HASHER_H__
+
+#include <cstddef>
+#include <utility>
+
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+
+// Must be included last.
+#include "google/protobuf/port_def.inc"
+
+namespace google {
+namespace protobuf {
+namespace util {
+
+// Hashes the logical contents of a message through reflection. The hash is
+// consistent with MessageDifferencer::Equals(): messages which compare equal
+// always hash equally, regardless of the order in which their fields were
+// set or parsed and of the iteration order of their map fields. This makes
+// it a cheaper dedup key than hashing deterministically serialized bytes,
+// which requires serializing the whole message and sorting its maps.
+//
+// Some contents do not contribute to the hash, so messages which are not
+// equal may still collide more often than the hash width suggests:
+// - unknown fields;
+// - the payload of google.protobuf.Any, since equal payloads may be
+//   serialized differently; only the full type name in the type URL is
+//   hashed.
+//
+// The hash is not stable across processes or binary versions and must not
+// be persisted.
+//
+// MessageHasher and MessageEquals can be used to key hash containers by
+// message contents:
+//
+//   absl::flat_hash_set<Foo, util::MessageHasher, util::MessageEquals> foos;
+class PROTOBUF_EXPORT MessageHasher {
+ public:
+  // Returns the hash of the contents of `message`.
+  static size_t Hash(const Message& message);
+
+  size_t operator()(const Message& message) const { return Hash(message); }
+
+ private:
+  static size_t HashAny(const Message& any);
+  static size_t HashFields(size_t hash, const Message& message);
+  static size_t HashField(size_t hash, const Message& message,
+                          const FieldDescriptor* field);
+  static size_t HashMapField(size_t hash, const Message& message,
+                             const FieldDescriptor* field);
+};
+
+// Compares messages with MessageDifferencer::Equals(). To be used together
+// with MessageHasher.
+struct PROTOBUF_EXPORT MessageEquals {
+  bool operator()(const Message& message1, const Message& message2) const;
+};
+
+// Allows the contents of a message to be combined into an absl::Hash state,
+// e.g. from the AbslHashValue() of a type holding a message:
+//
+//   template <typename H>
+//   friend H AbslHashValue(H state, const Key& key) {
+//     return H::combine(std::move(state), key.id,
+//                       util::HashableMessage(key.proto));
+//   }
+class HashableMessage {
+ public:
+  explicit HashableMessage(const Message& message) : message_(message) {}
+
+  template <typename H>
+  friend H AbslHashValue(H state, const HashableMessage& value) {
+    return H::combine(std::move(state), MessageHasher::Hash(value.message_));
+  }
+
+ private:
+  const Message& message_;
+};
+
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google
+
+#include "google/protobuf/port_undef.inc"
+
+#endif  // GOOGLE_PROTOBUF_UTIL_MESSAGE_HASHER_H__
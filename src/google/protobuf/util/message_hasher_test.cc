@@ -0,0 +1,154 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+//
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file or at
+// https://developers.google.com/open-source/licenses/bsd
+
+#include "google/protobuf/util/message_hasher.h"
+
+#include <string>
+
+#include "google/protobuf/any.pb.h"
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "google/protobuf/map_unittest.pb.h"
+#include "google/protobuf/test_util.h"
+#include "google/protobuf/unittest.pb.h"
+
+namespace google {
+namespace protobuf {
+namespace util {
+namespace {
+
+using ::protobuf_unittest::TestAllExtensions;
+using ::protobuf_unittest::TestAllTypes;
+using ::protobuf_unittest::TestMap;
+
+TEST(MessageHasherTest, EqualMessagesHashEqually) {
+  TestAllTypes message1;
+  TestAllTypes message2;
+  TestUtil::SetAllFields(&message1);
+  TestUtil::SetAllFields(&message2);
+  EXPECT_EQ(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+
+  message2.set_optional_int32(message2.optional_int32() + 1);
+  EXPECT_NE(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+}
+
+TEST(MessageHasherTest, IndependentOfWireOrder) {
+  TestAllTypes message1;
+  TestUtil::SetAllFields(&message1);
+
+  // Serialize the fields one at a time in reverse order and parse them back.
+  TestAllTypes remaining = message1;
+  std::string reversed;
+  for (int i = TestAllTypes::descriptor()->field_count() - 1; i >= 0; --i) {
+    TestAllTypes single;
+    single.GetReflection()->SwapFields(
+        &single, &remaining, {TestAllTypes::descriptor()->field(i)});
+    reversed.append(single.SerializeAsString());
+  }
+  TestAllTypes message2;
+  ASSERT_TRUE(message2.ParseFromString(reversed));
+  EXPECT_EQ(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+}
+
+TEST(MessageHasherTest, IndependentOfMapOrder) {
+  TestMap message1;
+  TestMap message2;
+  for (int i = 0; i < 100; ++i) {
+    (*message1.mutable_map_int32_int32())[i] = i * 3;
+    (*message1.mutable_map_string_string())[absl::StrCat("k", i)] = "v";
+    (*message2.mutable_map_int32_int32())[99 - i] = (99 - i) * 3;
+    (*message2.mutable_map_string_string())[absl::StrCat("k", 99 - i)] = "v";
+  }
+  EXPECT_EQ(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+
+  (*message2.mutable_map_int32_int32())[7] = 0;
+  EXPECT_NE(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+}
+
+TEST(MessageHasherTest, NegativeZero) {
+  TestAllTypes message1;
+  TestAllTypes message2;
+  message1.set_optional_double(0.0);
+  message2.set_optional_double(-0.0);
+  message1.add_repeated_float(0.0f);
+  message2.add_repeated_float(-0.0f);
+  EXPECT_EQ(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+}
+
+TEST(MessageHasherTest, Extensions) {
+  TestAllExtensions message1;
+  TestAllExtensions message2;
+  TestUtil::SetAllExtensions(&message1);
+  TestUtil::SetAllExtensions(&message2);
+  EXPECT_EQ(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+
+  message2.ClearExtension(protobuf_unittest::optional_int32_extension);
+  EXPECT_NE(MessageHasher::Hash(message1), MessageHasher::Hash(message2));
+}
+
+TEST(MessageHasherTest, AnyPayloadOrder) {
+  TestAllTypes first;
+  TestAllTypes second;
+  first.set_optional_int32(1);
+  second.set_optional_string("foo");
+  TestAllTypes payload = first;
+  payload.MergeFrom(second);
+
+  // Equal payloads serialized in different field order.
+  Any any1;
+  Any any2;
+  any1.PackFrom(payload);
+  any2.set_type_url(any1.type_url());
+  any2.set_value(absl::StrCat(second.SerializeAsString(),
+                              first.SerializeAsString()));
+  ASSERT_NE(any1.value(), any2.value());
+  ASSERT_TRUE(MessageEquals()(any1, any2));
+  EXPECT_EQ(MessageHasher::Hash(any1), MessageHasher::Hash(any2));
+}
+
+TEST(MessageHasherTest, AnyTypeUrlPrefix) {
+  TestAllTypes payload;
+  payload.set_optional_int32(1);
+
+  // The payload type is resolved from the full type name only.
+  Any any1;
+  Any any2;
+  any1.PackFrom(payload, "type.googleapis.com");
+  any2.PackFrom(payload, "example.com");
+  ASSERT_NE(any1.type_url(), any2.type_url());
+  ASSERT_TRUE(MessageEquals()(any1, any2));
+  EXPECT_EQ(MessageHasher::Hash(any1), MessageHasher::Hash(any2));
+}
+
+TEST(MessageHasherTest, FlatHashSet) {
+  absl::flat_hash_set<TestAllTypes, MessageHasher, MessageEquals> set;
+  TestAllTypes message;
+  TestUtil::SetAllFields(&message);
+  EXPECT_TRUE(set.insert(message).second);
+  EXPECT_FALSE(set.insert(message).second);
+
+  message.set_optional_string("other");
+  EXPECT_TRUE(set.insert(message).second);
+  EXPECT_EQ(set.size(), 2u);
+  EXPECT_TRUE(set.contains(message));
+}
+
+TEST(MessageHasherTest, HashableMessage) {
+  TestAllTypes message1;
+  TestAllTypes message2;
+  TestUtil::SetAllFields(&message1);
+  TestUtil::SetAllFields(&message2);
+  EXPECT_EQ(absl::HashOf(1, HashableMessage(message1)),
+            absl::HashOf(1, HashableMessage(message2)));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace protobuf
+}  // namespace google